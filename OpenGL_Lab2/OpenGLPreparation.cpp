@@ -8,6 +8,7 @@
 #include "VAO.h"
 #include "VBO.h"
 #include "EBO.h"
+#include "DynamicBuffer.h"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -22,11 +23,15 @@ using std::vector;
 vector<GLfloat> vertices;
 vector<GLuint> indices;
 
-VBO *VBO1;
+// Geometry is streamed every frame, so changing the shape only rewrites the vectors above
+const GLsizeiptr streamRegionSize = 64 * 1024;
+DynamicBuffer* vertexStream;
+DynamicBuffer* indexStream;
 VAO* VAO1;
-EBO *EBO1;
 
-void RefreshMesh();
+void CreateStreamingMesh();
+void DeleteStreamingMesh();
+bool StreamMesh(GLintptr& indexOffset, GLint& baseVertex);
 void RecalculateIndicies();
 
 #pragma region Shapes
@@ -34,56 +39,48 @@ void SetRightTriangleVerticies()
 {
 	vertices = { 0.f, 0.f, 0.f, 0.5f, 0.f, 0.f, 0.f, 0.5f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetIsoscelesTriangleVertices()
 {
 	vertices = { -0.5f, 0.f, 0.f, 0.5f, 0.f, 0.f, 0.f, 0.5f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetIsoscelesTrapezoidVertices()
 {
 	vertices = { -0.5f, 0.f, 0.f, -0.3f, 0.5f, 0.f, 0.3f, 0.5f, 0.f, 0.5f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetRightTrapezoidVertices()
 {
 	vertices = { -0.5f, 0.f, 0.f, -0.5f, 0.5f, 0.f, 0.3f, 0.5f, 0.f, 0.5f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetParallelogramVertices()
 {
 	vertices = { -0.5f, 0.f, 0.f, -0.3f, 0.5f, 0.f, 0.8f, 0.5f, 0.f, 0.5f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetRectangleVertices()
 {
 	vertices = { -0.5f, 0.f, 0.f, -0.5f, 0.3f, 0.f, 0.5f, 0.3f, 0.f, 0.5f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetDeltoidVertices()
 {
 	vertices = { 0.f, -0.5f, 0.f, -0.3f, 0.f, 0.f, 0.f, 0.3f, 0.f, 0.3f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetRhombusVertices()
 {
 	vertices = { 0.f, -0.7f, 0.f, -0.3f, 0.f, 0.f, 0.f, 0.7f, 0.f, 0.3f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void GenerateRegularPolygon(float x0, float y0, float radius, int n)
@@ -96,7 +93,6 @@ void GenerateRegularPolygon(float x0, float y0, float radius, int n)
 		vertices.push_back(0);
 	}
 	RecalculateIndicies();
-	RefreshMesh();
 }
 #pragma endregion
 
@@ -110,7 +106,6 @@ void ShowRandomPoints(int n)
 		vertices.push_back(0);
 	}
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 
@@ -133,10 +128,10 @@ int main()
 	glEnable(GL_DEPTH_TEST);
 
 	Shader shader("./src/shaders/default.shader");
+	CreateStreamingMesh();
 
 	int polygonPointsCount = 3;
 	GenerateRegularPolygon(0.f, 0.f, 0.3f, polygonPointsCount);
-	RefreshMesh();
 
 	int frontPolygonsMode = GL_FILL;
 	int backPolygonsMode = GL_FILL;
@@ -155,15 +150,22 @@ int main()
 		shader.Bind();
 		VAO1->Bind();
 
-		// Draw back
-		glCullFace(GL_BACK);
-		glPolygonMode(GL_FRONT_AND_BACK, backPolygonsMode);
-		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-
-		// Draw front
-		glCullFace(GL_FRONT);
-		glPolygonMode(GL_FRONT_AND_BACK, frontPolygonsMode);
-		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+		GLintptr indexOffset;
+		GLint baseVertex;
+		if (StreamMesh(indexOffset, baseVertex))
+		{
+			// Draw back
+			glCullFace(GL_BACK);
+			glPolygonMode(GL_FRONT_AND_BACK, backPolygonsMode);
+			glDrawElementsBaseVertex(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, (void*)indexOffset, baseVertex);
+
+			// Draw front
+			glCullFace(GL_FRONT);
+			glPolygonMode(GL_FRONT_AND_BACK, frontPolygonsMode);
+			glDrawElementsBaseVertex(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, (void*)indexOffset, baseVertex);
+		}
+		vertexStream->EndFrame();
+		indexStream->EndFrame();
 
 		shader.Unbind();
 
@@ -250,6 +252,7 @@ int main()
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
 
+	DeleteStreamingMesh();
 	glfwDestroyWindow(window);
 	glfwTerminate();
 
@@ -267,18 +270,39 @@ void RecalculateIndicies()
 	}
 }
 
-void RefreshMesh()
+void CreateStreamingMesh()
 {
-	VBO1 = new VBO(&vertices[0], sizeof(GLfloat) * vertices.size());
+	vertexStream = new DynamicBuffer(GL_ARRAY_BUFFER, streamRegionSize, 3 * sizeof(GLfloat));
+	indexStream = new DynamicBuffer(GL_ELEMENT_ARRAY_BUFFER, streamRegionSize, sizeof(GLuint));
 
 	VAO1 = new VAO();
 	VAO1->Bind();
+	indexStream->Bind();
+	vertexStream->Bind();
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
 
-	EBO1 = new EBO(&indices[0], sizeof(GLuint) * indices.size());
+	VAO1->Unbind();
+	vertexStream->Unbind();
+	indexStream->Unbind();
+}
 
-	VAO1->LinkAttrib(*VBO1, 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+void DeleteStreamingMesh()
+{
+	VAO1->Delete();
+	delete VAO1;
+	delete vertexStream;
+	delete indexStream;
+}
 
-	VAO1->Unbind();
-	VBO1->Unbind();
-	EBO1->Unbind();
-}
\ No newline at end of file
+// Writes this frame's vertices and indices into the streams. Returns false if they don't fit
+bool StreamMesh(GLintptr& indexOffset, GLint& baseVertex)
+{
+	vertexStream->BeginFrame();
+	indexStream->BeginFrame();
+
+	GLintptr vertexOffset = vertexStream->Write(vertices.data(), sizeof(GLfloat) * vertices.size());
+	indexOffset = indexStream->Write(indices.data(), sizeof(GLuint) * indices.size());
+	baseVertex = (GLint)(vertexOffset / (3 * sizeof(GLfloat)));
+	return vertexOffset != -1 && indexOffset != -1;
+}
@@ -0,0 +1,105 @@
+#include "DynamicBuffer.h"
+#include <cstring>
+#include <iostream>
+
+DynamicBuffer::DynamicBuffer(GLenum target, GLsizeiptr regionSize, GLsizeiptr alignment)
+	: m_Target(target), m_Alignment(alignment)
+{
+	// Every region starts at an aligned offset
+	m_RegionSize = (regionSize + alignment - 1) / alignment * alignment;
+	GLsizeiptr totalSize = m_RegionSize * FRAMES_IN_FLIGHT;
+
+	glGenBuffers(1, &ID);
+	glBindBuffer(m_Target, ID);
+	if (GLEW_ARB_buffer_storage)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(m_Target, totalSize, nullptr, flags);
+		m_Mapped = (char*)glMapBufferRange(m_Target, 0, totalSize, flags);
+	}
+	else
+	{
+		glBufferData(m_Target, totalSize, nullptr, GL_STREAM_DRAW);
+	}
+}
+
+DynamicBuffer::~DynamicBuffer()
+{
+	for (GLsync fence : m_Fences)
+	{
+		if (fence)
+			glDeleteSync(fence);
+	}
+	if (m_Mapped)
+	{
+		glBindBuffer(m_Target, ID);
+		glUnmapBuffer(m_Target);
+	}
+	glDeleteBuffers(1, &ID);
+}
+
+void DynamicBuffer::BeginFrame()
+{
+	m_Region = (m_Region + 1) % FRAMES_IN_FLIGHT;
+	m_RegionOffset = 0;
+	if (!m_FrameOverflowed)
+		m_OverflowReported = false;
+	m_FrameOverflowed = false;
+
+	GLsync& fence = m_Fences[m_Region];
+	if (!fence)
+		return;
+
+	// Normally the region was consumed long ago and the first check returns at once
+	GLenum status = glClientWaitSync(fence, 0, 0);
+	while (status == GL_TIMEOUT_EXPIRED)
+		status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+void DynamicBuffer::EndFrame()
+{
+	if (m_Fences[m_Region])
+		glDeleteSync(m_Fences[m_Region]);
+	m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLintptr DynamicBuffer::Write(const void* data, GLsizeiptr size)
+{
+	GLsizeiptr alignedOffset = (m_RegionOffset + m_Alignment - 1) / m_Alignment * m_Alignment;
+	if (alignedOffset + size > m_RegionSize)
+	{
+		// The same data usually overflows again every frame, so don't flood the console
+		m_FrameOverflowed = true;
+		if (!m_OverflowReported)
+		{
+			std::cout << "DYNAMIC BUFFER OVERFLOW: " << size << " bytes don't fit in a " << m_RegionSize << " bytes region" << std::endl;
+			m_OverflowReported = true;
+		}
+		return -1;
+	}
+
+	GLintptr offset = m_Region * m_RegionSize + alignedOffset;
+	if (m_Mapped)
+	{
+		memcpy(m_Mapped + offset, data, size);
+	}
+	else
+	{
+		glBindBuffer(m_Target, ID);
+		glBufferSubData(m_Target, offset, size, data);
+	}
+	m_RegionOffset = alignedOffset + size;
+	return offset;
+}
+
+void DynamicBuffer::Bind()
+{
+	glBindBuffer(m_Target, ID);
+}
+
+void DynamicBuffer::Unbind()
+{
+	glBindBuffer(m_Target, 0);
+}
@@ -12,6 +12,7 @@
 #include "VAO.h"
 #include "VBO.h"
 #include "EBO.h"
+#include "DynamicBuffer.h"
 #include "camera.h"
 #include "timeManager.h"
 
@@ -30,11 +31,15 @@ using std::vector;
 vector<GLfloat> vertices;
 vector<GLuint> indices;
 
-VBO *VBO1;
+// Geometry is streamed every frame, so changing the shape only rewrites the vectors above
+const GLsizeiptr streamRegionSize = 64 * 1024;
+DynamicBuffer* vertexStream;
+DynamicBuffer* indexStream;
 VAO* VAO1;
-EBO *EBO1;
 
-void RefreshMesh();
+void CreateStreamingMesh();
+void DeleteStreamingMesh();
+bool StreamMesh(GLintptr& indexOffset, GLint& baseVertex);
 void RecalculateIndicies(bool startZero = true);
 
 #pragma region Flat Shapes
@@ -42,21 +47,18 @@ void SetRightTriangleVerticies()
 {
 	vertices = { 0.f, 0.f, 0.f, 0.5f, 0.f, 0.f, 0.f, 0.5f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetRectangleVertices()
 {
 	vertices = { -0.5f, 0.f, 0.f, -0.5f, 0.3f, 0.f, 0.5f, 0.3f, 0.f, 0.5f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 
 void SetRhombusVertices()
 {
 	vertices = { 0.f, -0.7f, 0.f, -0.3f, 0.f, 0.f, 0.f, 0.7f, 0.f, 0.3f, 0.0f, 0.f };
 	RecalculateIndicies();
-	RefreshMesh();
 }
 #pragma endregion
 
@@ -149,7 +151,6 @@ void SetTwoSheetedHyperboloidVertices()
 	indices.clear();
 	AddTwoSheetedHyperboloidVertices(-1, a, b, c, AddTwoSheetedHyperboloidVertices(1, a, b, c));
 
-	RefreshMesh();
 }
 
 void RenderTree(int numOfCylinders)
@@ -191,6 +192,7 @@ int main()
 	glEnable(GL_DEPTH_TEST);
 
 	Camera camera(width, height, glm::vec3(0.0f, 0.0f, 2.0f));
+	CreateStreamingMesh();
 
 
 	SetTwoSheetedHyperboloidVertices();
@@ -261,8 +263,12 @@ int main()
 		shader.SetUniformMat4f("model", figureModelMatrix);
 		shader.SetUniform3f("color", r, 1.f - r, 1.f);
 
-		if(!renderTree)
-			glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+		GLintptr indexOffset;
+		GLint baseVertex;
+		if(!renderTree && StreamMesh(indexOffset, baseVertex))
+			glDrawElementsBaseVertex(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, (void*)indexOffset, baseVertex);
+		vertexStream->EndFrame();
+		indexStream->EndFrame();
 
 		shader.Unbind();
 
@@ -322,6 +328,7 @@ int main()
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
 
+	DeleteStreamingMesh();
 	glfwDestroyWindow(window);
 	glfwTerminate();
 
@@ -339,18 +346,39 @@ void RecalculateIndicies(bool startZero)
 	}
 }
 
-void RefreshMesh()
+void CreateStreamingMesh()
 {
-	VBO1 = new VBO(&vertices[0], sizeof(GLfloat) * vertices.size());
+	vertexStream = new DynamicBuffer(GL_ARRAY_BUFFER, streamRegionSize, 3 * sizeof(GLfloat));
+	indexStream = new DynamicBuffer(GL_ELEMENT_ARRAY_BUFFER, streamRegionSize, sizeof(GLuint));
 
 	VAO1 = new VAO();
 	VAO1->Bind();
+	indexStream->Bind();
+	vertexStream->Bind();
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
 
-	EBO1 = new EBO(&indices[0], sizeof(GLuint) * indices.size());
+	VAO1->Unbind();
+	vertexStream->Unbind();
+	indexStream->Unbind();
+}
+
+void DeleteStreamingMesh()
+{
+	VAO1->Delete();
+	delete VAO1;
+	delete vertexStream;
+	delete indexStream;
+}
 
-	VAO1->LinkAttrib(*VBO1, 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+// Writes this frame's vertices and indices into the streams. Returns false if they don't fit
+bool StreamMesh(GLintptr& indexOffset, GLint& baseVertex)
+{
+	vertexStream->BeginFrame();
+	indexStream->BeginFrame();
 
-	VAO1->Unbind();
-	VBO1->Unbind();
-	EBO1->Unbind();
-}
\ No newline at end of file
+	GLintptr vertexOffset = vertexStream->Write(vertices.data(), sizeof(GLfloat) * vertices.size());
+	indexOffset = indexStream->Write(indices.data(), sizeof(GLuint) * indices.size());
+	baseVertex = (GLint)(vertexOffset / (3 * sizeof(GLfloat)));
+	return vertexOffset != -1 && indexOffset != -1;
+}
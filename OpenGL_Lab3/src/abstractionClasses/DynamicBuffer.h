@@ -0,0 +1,48 @@
+#pragma once
+#include <GL/glew.h>
+
+/// <summary>
+/// Ring buffer for geometry that is rewritten every frame.
+/// The storage is split into regions, one per frame in flight, and mapped once with GL_MAP_PERSISTENT_BIT.
+/// Each region is guarded by a fence, so the CPU never writes into data the GPU is still reading.
+/// Without ARB_buffer_storage it falls back to glBufferSubData into the same regions
+/// </summary>
+class DynamicBuffer
+{
+public:
+	static const int FRAMES_IN_FLIGHT = 3;
+private:
+	GLenum m_Target;
+	GLsizeiptr m_RegionSize;
+	GLsizeiptr m_Alignment;
+	char* m_Mapped = nullptr;
+	GLsync m_Fences[FRAMES_IN_FLIGHT] = {};
+	int m_Region = 0;
+	GLsizeiptr m_RegionOffset = 0;
+	// An overflow is reported once, then again only after a frame that fit
+	bool m_OverflowReported = false;
+	bool m_FrameOverflowed = false;
+public:
+	GLuint ID;
+
+	// regionSize is the most that can be written in one frame: everything written
+	// between BeginFrame and EndFrame must fit in it (the labs use streamRegionSize, 64 KiB).
+	// Offsets returned by Write are multiples of alignment, e.g. the vertex stride for glDrawElementsBaseVertex
+	DynamicBuffer(GLenum target, GLsizeiptr regionSize, GLsizeiptr alignment = 4);
+	~DynamicBuffer();
+
+	DynamicBuffer(const DynamicBuffer&) = delete;
+	DynamicBuffer& operator=(const DynamicBuffer&) = delete;
+
+	// Moves to the next region, waiting for its fence if the GPU is still using it
+	void BeginFrame();
+	// Fences the region written this frame. Call after the last draw that reads it
+	void EndFrame();
+
+	// Copies data into the current region. Returns its byte offset in the buffer, or -1 if the region is full,
+	// in which case the caller should skip the draw. Overflowing frames in a row are reported to the console once
+	GLintptr Write(const void* data, GLsizeiptr size);
+
+	void Bind();
+	void Unbind();
+};
@@ -16,80 +16,135 @@
 #include "camera.h"
 #include "Mesh.h"
 #include "LightCube.h"
+#include "LightUniformBlock.h"
+#include "CameraUniformBlock.h"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 
 #include "timeManager.h"
-
-constexpr float PI = 3.1415926535979f;
-
+#include "GLStateCache.h"
+#include "ShaderLibrary.h"
+#include "ShaderVariants.h"
+#include "GLHandles.h"
+#include "ParametricSurface.h"
+#include "MeshBuildJob.h"
+#include "LodSelector.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "threadPool.h"
 
 const unsigned int width = 660;
 const unsigned int height = 660;
+// Written by the framebuffer size callback, applied to the camera and viewport at frame start
+int framebufferWidth = width, framebufferHeight = height;
+
+// Size of the lights uniform block, the lit shader is compiled for the same number
+const int maxLights = 256;
 
 
 using std::cout;
 using std::vector;
 
-vector<Vertex> vertices;
-
-vector<GLuint> indices;
-
-vector<Vertex> lightVertices =
-{ 
-	Vertex{glm::vec3(-0.1f, -0.1f,  0.1f)},
-	Vertex{glm::vec3(-0.1f, -0.1f, -0.1f)},
-	Vertex{glm::vec3(0.1f, -0.1f, -0.1f)},
-	Vertex{glm::vec3(0.1f, -0.1f,  0.1f)},
-	Vertex{glm::vec3(-0.1f,  0.1f,  0.1f)},
-	Vertex{glm::vec3(-0.1f,  0.1f, -0.1f)},
-	Vertex{glm::vec3(0.1f,  0.1f, -0.1f)},
-	Vertex{glm::vec3(0.1f,  0.1f,  0.1f)}
-};
-
-vector<GLuint> lightIndices =
-{
-	0, 1, 2,
-	0, 2, 3,
-	0, 4, 7,
-	0, 7, 3,
-	3, 7, 6,
-	3, 6, 2,
-	2, 6, 5,
-	2, 5, 1,
-	1, 5, 4,
-	1, 4, 0,
-	4, 5, 6,
-	4, 6, 7
-};
-
 void InitializeDependenciesAndWindow(GLFWwindow** window);
+void RunScene(GLFWwindow* window);
+std::shared_ptr<MeshBuildJob> StartMeshBuild();
 void SetCubeVertices();
-void SetSphereVertices(float radius, unsigned int rings, unsigned int sectors);
+void SetSurfaceVertices(ParametricSurface::Type type, unsigned int rings, unsigned int sectors);
 void SetPyramidVertices();
+void SwapInFinishedMesh();
+MeshData MakeCubeData();
+MeshData MakePyramidData();
 
+// The displayed mesh and the one the next build is uploaded to. They're swapped at frame start,
+// so an upload never writes to buffers the previous frame may still be reading
 Mesh* mesh;
+Mesh* backMesh = nullptr;
+MeshSettings meshSettings;
+// Milliseconds spent building the last mesh
+double lastBuildTime = 0.0;
+// Meshes are built on meshWorkers and handed to the render thread through finishedMeshBuilds.
+// The queue is declared first, so it outlives the tasks still running when the pool is destroyed
+MeshBuildJob::Queue finishedMeshBuilds;
+ThreadPool meshWorkers;
+std::shared_ptr<MeshBuildJob> pendingMeshBuild;
 
 int main()
 {
 	GLFWwindow* window;
 	InitializeDependenciesAndWindow(&window);
 
+	// Scene objects release their GL resources when they go out of scope, which needs a live context
+	RunScene(window);
+	GLResourceRegistry::ReportLeaks();
 
-	Shader* litShader = new Shader("./src/shaders/lit.shader");
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return 0;
+}
+
+void RunScene(GLFWwindow* window)
+{
 
-	litShader->Bind();
-	litShader->SetUniform1i("numOfLights", 2);
-	litShader->SetUniformMat4f("model", glm::mat4(1.f));
+	LightUniformBlock lights(maxLights);
+	lights.SetNumOfLights(2);
+	// View and projection of every shader, published once per frame
+	CameraUniformBlock cameraBlock;
 
-	SetSphereVertices(0.5f, 25, 25);
-	mesh = new Mesh(vertices, indices);
+	ShaderVariants litShaders("./src/shaders/lit.shader", { "MAX_LIGHTS " + std::to_string(lights.GetMaxLights()) },
+		[&lights, &cameraBlock](Shader& shader)
+		{
+			lights.Attach(shader);
+			cameraBlock.Attach(shader);
+			shader.Bind();
+			shader.SetUniformMat4f("model", glm::mat4(1.f));
+			shader.SetUniformMat4f("dequantization", glm::mat4(1.f));
+		});
+	// Both texture permutations are submitted up front and compile in the background,
+	// the mesh is drawn with the fallback (dynamic light loop, no texture) until they're ready
+	litShaders.Request(ShaderVariants::MakeKey(false, lights.GetNumOfLights()));
+	litShaders.Request(ShaderVariants::MakeKey(true, lights.GetNumOfLights()));
+
+	ParametricSurface::Type surfaceType = ParametricSurface::Type::Sphere;
+	int surfaceRings = 25, surfaceSectors = 25;
+	ParametricSurface::GenerateBenchmark generateBenchmark = {};
+	std::vector<ParametricSurface::ScalingBenchmark> scalingBenchmark;
+	meshSettings.format = VertexFormat::PackedQuantized;
+	meshSettings.optimize = true;
+	// The first mesh is needed before the first frame
+	mesh = new Mesh(ParametricSurface::GenerateLods(ParametricSurface::CreateLodChain(surfaceType, surfaceRings, surfaceSectors)), nullptr, meshSettings);
+	LodSelector lodSelector;
 	Texture *texture = new Texture("./textures/pixel.jpg", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGB, GL_UNSIGNED_BYTE);
 
-	LightCube light1(glm::vec3(1.f, 0.f, 0.0f), 0, new Shader("./src/shaders/unlit.shader"), litShader);
-	LightCube light2(glm::vec3(1.0f, 1.0f, 0.0f), 1, new Shader("./src/shaders/unlit.shader"), litShader);
+	std::shared_ptr<Shader> gizmoShader = ShaderLibrary::Load("./src/shaders/unlit.shader", { "INSTANCED" });
+	cameraBlock.Attach(*gizmoShader);
+	LightCube light1(glm::vec3(1.f, 0.f, 0.0f), 0, &lights);
+	LightCube light2(glm::vec3(1.0f, 1.0f, 0.0f), 1, &lights);
+	// Every light gizmo is drawn with one instanced draw call
+	InstancedMesh lightGizmos(LightCube::MakeGizmoData());
+
+	// Every draw goes through the queue, it's sorted by state before replaying
+	RenderQueue renderQueue;
+	RenderQueue::SortBenchmark sortBenchmark = {};
+	// Objects outside the view aren't submitted
+	FrustumCuller culler;
+	CullBenchmark cullBenchmark = {};
+
+	// Small objects sharing one vertex pool, drawn with one multi-draw call
+	MeshPool meshPool(64 * 1024, 256 * 1024);
+	std::vector<PooledMesh> pooledShapes;
+	for (int type = 0; type < 5; type++)
+		pooledShapes.push_back(meshPool.Allocate(ParametricSurface::Create((ParametricSurface::Type)type, 12, 12).Generate()));
+	pooledShapes.push_back(meshPool.Allocate(MakeCubeData()));
+	pooledShapes.push_back(meshPool.Allocate(MakePyramidData()));
+	const glm::vec4 pooledColors[] = { glm::vec4(0.9f, 0.4f, 0.3f, 1.f), glm::vec4(0.3f, 0.8f, 0.4f, 1.f), glm::vec4(0.3f, 0.5f, 0.9f, 1.f) };
+	std::shared_ptr<Shader> pooledShader = ShaderLibrary::Load("./src/shaders/pooled.shader", RenderQueue::GetShaderDefines());
+	cameraBlock.Attach(*pooledShader);
+	if (RenderQueue::IsMultiDrawSupported())
+		pooledShader->BindStorageBlock("Draws", RenderQueue::DRAW_DATA_BINDING);
+	int pooledObjectCount = 100;
+	std::vector<glm::mat4> pooledModels;
 
 
 	Camera camera(width, height, glm::vec3(0.0f, 0.0f, 2.0f));
@@ -97,6 +152,7 @@ int main()
 
 	bool mouseIsOverMeshGui = false;
 	bool mouseIsOverControlsGui = false;
+	bool mouseIsOverStatsGui = false;
 
 	int polygonMode = GL_FILL;
 
@@ -115,7 +171,12 @@ int main()
 				*changeBlueChannel = !*changeBlueChannel;
 		}
 	);
-
+	glfwSetFramebufferSizeCallback(window,
+		[](GLFWwindow* window, int newWidth, int newHeight) {
+			framebufferWidth = newWidth;
+			framebufferHeight = newHeight;
+		}
+	);
 
 	// Light 2 rotation
 	float rotationAngle = 0.f;
@@ -126,10 +187,24 @@ int main()
 	while (!glfwWindowShouldClose(window))
 	{
 		Time::SetNow();
+		SwapInFinishedMesh();
+		unsigned int uniformQueriesLastFrame = Shader::GetLocationQueries();
+		unsigned int issuedStateCallsLastFrame = GLStateCache::GetIssuedCalls();
+		unsigned int elidedStateCallsLastFrame = GLStateCache::GetElidedCalls();
+		Shader::ResetLocationQueries();
+		GLStateCache::ResetFrameCounters();
+
+		// A minimised window reports 0x0, the old size is kept so the aspect ratio stays finite
+		if (framebufferWidth > 0 && framebufferHeight > 0 && (framebufferWidth != camera.GetWidth() || framebufferHeight != camera.GetHeight()))
+		{
+			glViewport(0, 0, framebufferWidth, framebufferHeight);
+			camera.SetSize(framebufferWidth, framebufferHeight);
+		}
+
 		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glPolygonMode(GL_FRONT_AND_BACK, polygonMode);
+		GLStateCache::PolygonMode(polygonMode);
 
 		if (glfwGetKey(window, GLFW_KEY_KP_8) == GLFW_PRESS)
 			light1.Move(10.f * Time::GetDeltaTime(), 0.f, 0.f);
@@ -154,7 +229,7 @@ int main()
 		if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
 			rotationSpeed -= 0.1f;
 
-		camera.HandleInputs(window, mouseIsOverMeshGui || mouseIsOverControlsGui);
+		camera.HandleInputs(window, mouseIsOverMeshGui || mouseIsOverControlsGui || mouseIsOverStatsGui);
 		
 		if (rotateLight)
 		{
@@ -162,9 +237,44 @@ int main()
 			rotationAngle += rotationSpeed * Time::GetDeltaTime();
 		}
 
-		mesh->Render(*litShader, camera);
-		if(light1IsEnabled) light1.Render(camera);
-		if(light2IsEnabled) light2.Render(camera);
+		lights.Upload();
+		cameraBlock.Upload(camera);
+		lodSelector.Update(*mesh, camera);
+
+		// Every object's box is culled in one pass before anything is submitted
+		culler.SetViewProjection(camera.GetViewProjection());
+		culler.Clear();
+		size_t meshCullIndex = culler.Add(mesh->GetBox());
+		size_t firstPooledCullIndex = culler.GetCount();
+		// Grid of pooled objects below the mesh, every shape scaled to the same size
+		int gridSize = (int)std::ceil(std::sqrt((float)pooledObjectCount));
+		pooledModels.resize(pooledObjectCount);
+		for (int i = 0; i < pooledObjectCount; i++)
+		{
+			const PooledMesh& shape = pooledShapes[i % pooledShapes.size()];
+			glm::vec3 position((i % gridSize - gridSize * 0.5f) * 0.4f, -1.f, (i / gridSize - gridSize * 0.5f) * 0.4f);
+			pooledModels[i] = glm::scale(glm::translate(glm::mat4(1.f), position), glm::vec3(0.15f / shape.bounds.radius));
+			culler.Add(shape.box, pooledModels[i]);
+		}
+		culler.Cull();
+
+		if (culler.IsVisible(meshCullIndex))
+			renderQueue.Submit(*mesh, litShaders.Get(ShaderVariants::MakeKey(mesh->texture != nullptr, lights.GetNumOfLights())),
+				glm::distance(camera.GetPosition(), mesh->GetBounds().center));
+		lightGizmos.Clear();
+		if (light1IsEnabled) light1.AddGizmo(lightGizmos);
+		if (light2IsEnabled) light2.AddGizmo(lightGizmos);
+		renderQueue.Submit(lightGizmos, *gizmoShader, 0.f);
+
+		for (int i = 0; i < pooledObjectCount; i++)
+		{
+			if (!culler.IsVisible(firstPooledCullIndex + i))
+				continue;
+			glm::vec3 position = glm::vec3(pooledModels[i][3]);
+			renderQueue.Submit(meshPool, pooledShapes[i % pooledShapes.size()], *pooledShader, pooledModels[i], pooledColors[i % 3],
+				glm::distance(camera.GetPosition(), position));
+		}
+		renderQueue.Flush();
 
 #pragma region GUI
 		ImGui_ImplOpenGL3_NewFrame();
@@ -183,8 +293,27 @@ int main()
 		ImGui::Begin("Mesh/Texture/Light");
 		mouseIsOverMeshGui = ImGui::IsWindowHovered() || ImGui::IsWindowFocused();
 		ImGui::Text("Mesh");
-		if (ImGui::Button("Sphere"))
-			SetSphereVertices(0.5f, 25, 25);
+		const char* surfaceNames[] = { "Sphere", "Torus", "Cylinder", "Cone", "Hyperboloid" };
+		bool surfaceChanged = false;
+		for (int i = 0; i < 5; i++)
+		{
+			if (i > 0)
+				ImGui::SameLine();
+			if (ImGui::Button(surfaceNames[i]))
+			{
+				surfaceType = (ParametricSurface::Type)i;
+				surfaceChanged = true;
+			}
+		}
+		// Large surfaces take seconds to build, so they're rebuilt once the slider is released. Ctrl+click types a value
+		ImGui::SliderInt("Rings", &surfaceRings, 3, 4096, "%d", ImGuiSliderFlags_Logarithmic);
+		surfaceChanged |= ImGui::IsItemDeactivatedAfterEdit();
+		ImGui::SliderInt("Sectors", &surfaceSectors, 3, 4096, "%d", ImGuiSliderFlags_Logarithmic);
+		surfaceChanged |= ImGui::IsItemDeactivatedAfterEdit();
+		ImGui::SliderFloat("LOD error (px)", &lodSelector.maxScreenError, 0.1f, 20.f);
+		ImGui::SliderInt("Pooled objects", &pooledObjectCount, 0, 10000);
+		if (surfaceChanged)
+			SetSurfaceVertices(surfaceType, surfaceRings, surfaceSectors);
 		if (ImGui::Button("Pyramid"))
 			SetPyramidVertices();
 		if (ImGui::Button("Cube"))
@@ -208,8 +337,64 @@ int main()
 		if (ImGui::Button("Switch light rotation"))
 			rotateLight = !rotateLight;
 		ImGui::End();
+
+		ImGui::Begin("Stats");
+		mouseIsOverStatsGui = ImGui::IsWindowHovered() || ImGui::IsWindowFocused();
+		ImGui::Text("Uniform location queries: %u", uniformQueriesLastFrame);
+		ImGui::Text("State calls issued: %u", issuedStateCallsLastFrame);
+		ImGui::Text("State calls elided: %u", elidedStateCallsLastFrame);
+		ImGui::Text("Shader programs: %u", (unsigned int)ShaderLibrary::GetLoadedCount());
+		const ShaderLoadStats& shaderLoads = Shader::GetLoadStats();
+		ImGui::Text("Shader startup: %u cold in %.1f ms, %u warm from cache in %.1f ms", shaderLoads.coldLoads, shaderLoads.coldMilliseconds,
+			shaderLoads.warmLoads, shaderLoads.warmMilliseconds);
+		ImGui::Text("Mesh memory: GPU %.1f KB, last upload %.1f KB, RAM %.1f KB",
+			mesh->GetGpuBytes() / 1024.f, mesh->GetUploadedBytes() / 1024.f, mesh->GetCpuBytes() / 1024.f);
+		ImGui::Text("Vertex size: %d bytes (%d as float32), index size: %d bytes", mesh->GetLayout().GetStride(), (int)sizeof(Vertex), (int)mesh->GetIndexSize());
+		ImGui::Text("Mesh built in %.3f ms on %u threads%s", lastBuildTime, meshWorkers.GetThreadCount(), pendingMeshBuild ? ", building..." : "");
+		if (ImGui::Button("Generate 4096x4096 sphere"))
+			generateBenchmark = ParametricSurface::MeasureGenerate(ParametricSurface::Type::Sphere, 4096, 4096);
+		if (generateBenchmark.vertices > 0)
+			ImGui::Text("Generated %u vertices, %u triangles in %.1f ms on 1 thread", (unsigned int)generateBenchmark.vertices,
+				(unsigned int)generateBenchmark.triangles, generateBenchmark.milliseconds);
+		if (ImGui::Button("Generate 2048x2048 sphere on 1..N threads"))
+			scalingBenchmark = ParametricSurface::MeasureScaling(ParametricSurface::Type::Sphere, 2048, 2048, std::max(1u, std::thread::hardware_concurrency()));
+		for (const ParametricSurface::ScalingBenchmark& run : scalingBenchmark)
+			ImGui::Text("  %u threads: %.1f ms, %.2fx", run.threads, run.milliseconds, run.speedup);
+		ImGui::Text("Vertex cache ACMR: %.3f -> %.3f, ATVR: %.3f -> %.3f",
+			mesh->GetCacheStatsBefore().acmr, mesh->GetCacheStatsAfter().acmr, mesh->GetCacheStatsBefore().atvr, mesh->GetCacheStatsAfter().atvr);
+		// Rebuilding a mesh must leave these unchanged
+		ImGui::Text("Live GL buffers: %d, vertex arrays: %d, textures: %d, programs: %d",
+			GLResourceRegistry::GetLiveCount(GLResourceKind::Buffer), GLResourceRegistry::GetLiveCount(GLResourceKind::VertexArray),
+			GLResourceRegistry::GetLiveCount(GLResourceKind::Texture), GLResourceRegistry::GetLiveCount(GLResourceKind::Program));
+		ImGui::Text("Light gizmos: %u instances in 1 draw call", (unsigned int)lightGizmos.GetInstanceCount());
+		ImGui::Text("Pool: %u/%u vertices, %u/%u indices", (unsigned int)meshPool.GetUsedVertices(), (unsigned int)meshPool.GetVertexCapacity(),
+			(unsigned int)meshPool.GetUsedIndices(), (unsigned int)meshPool.GetIndexCapacity());
+		const RenderQueueStats& sorted = renderQueue.GetLastStats();
+		const RenderQueueStats& unsorted = renderQueue.GetLastUnsortedStats();
+		ImGui::Text("Render queue: %u items in %u draw calls (%u unsorted)", sorted.items, sorted.drawCalls, unsorted.drawCalls);
+		ImGui::Text("Program/texture/VAO changes: %u/%u/%u (%u/%u/%u unsorted)", sorted.programChanges, sorted.textureChanges, sorted.vertexArrayChanges,
+			unsorted.programChanges, unsorted.textureChanges, unsorted.vertexArrayChanges);
+		if (ImGui::Button("Sort 100k synthetic items"))
+			sortBenchmark = RenderQueue::MeasureSort(100000);
+		if (sortBenchmark.sorted.items > 0)
+			ImGui::Text("Sorted in %.3f ms, program/texture/VAO changes %u/%u/%u -> %u/%u/%u", sortBenchmark.milliseconds,
+				sortBenchmark.unsorted.programChanges, sortBenchmark.unsorted.textureChanges, sortBenchmark.unsorted.vertexArrayChanges,
+				sortBenchmark.sorted.programChanges, sortBenchmark.sorted.textureChanges, sortBenchmark.sorted.vertexArrayChanges);
+		ImGui::Text("Frustum culling: %u of %u objects visible", (unsigned int)culler.GetVisibleCount(), (unsigned int)culler.GetCount());
+		if (ImGui::Button("Cull 1M synthetic objects"))
+			cullBenchmark = FrustumCuller::MeasureCull(1000000);
+		if (cullBenchmark.objects > 0)
+			ImGui::Text("Culled in %.3f ms, %.2f ns/object, %u visible", cullBenchmark.milliseconds, cullBenchmark.nanosecondsPerObject,
+				(unsigned int)cullBenchmark.visible);
+		ImGui::Text("Lit variants compiling: %u", (unsigned int)litShaders.GetPendingCount());
+		ImGui::Text("LOD %u of %u: %d triangles, error %.2f px", (unsigned int)mesh->GetCurrentLod(), (unsigned int)mesh->GetLodCount(),
+			mesh->GetIndexCount() / 3, lodSelector.GetScreenError());
+		for (const LodTransition& transition : lodSelector.GetTransitions())
+			ImGui::Text("  frame %llu: LOD %u -> %u (%.2f px)", transition.frame, (unsigned int)transition.from, (unsigned int)transition.to, transition.screenError);
+		ImGui::End();
 		
 		ImGui::Render();
+		// The backend restores every binding it changes, so GLStateCache stays valid
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 #pragma endregion
 
@@ -229,9 +414,12 @@ int main()
 		Time::Calculate();
 	}
 
-	glfwDestroyWindow(window);
-	glfwTerminate();
-	return 0;
+	if (pendingMeshBuild)
+		pendingMeshBuild->Cancel();
+	delete mesh;
+	delete backMesh;
+	mesh = backMesh = nullptr;
+	delete texture;
 }
 
 void InitializeDependenciesAndWindow(GLFWwindow** window)
@@ -242,18 +430,20 @@ void InitializeDependenciesAndWindow(GLFWwindow** window)
 	glfwMakeContextCurrent(*window);
 	if (glewInit() != GLEW_OK)
 		cout << "Glew Init Error!";
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_DEPTH_TEST);
+	GLStateCache::SetBlend(true);
+	GLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLStateCache::SetDepthTest(true);
+	Shader::EnableParallelCompile();
 
 	ImGui::CreateContext();
 	ImGui_ImplGlfw_InitForOpenGL(*window, true);
 	ImGui_ImplOpenGL3_Init("#version 130");
 }
 
-void SetPyramidVertices()
+MeshData MakePyramidData()
 {
-	vertices =
+	MeshData data;
+	data.vertices =
 	{
 		// Bottom
 		Vertex{glm::vec3(-0.5f, 0.0f,  0.5f), glm::vec2(0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)},
@@ -282,7 +472,7 @@ void SetPyramidVertices()
 		Vertex{glm::vec3(0.0f, 0.8f,  0.0f), glm::vec2(2.5f, 5.0f), glm::vec3(0.0f, 0.5f,  0.8f)},
 	};
 
-	indices =
+	data.indices =
 	{
 		0, 1, 2,
 		0, 2, 3,
@@ -292,104 +482,60 @@ void SetPyramidVertices()
 		13, 15, 14
 	};
 
-	delete mesh;
-	mesh = new Mesh(vertices, indices);
+	return data;
 }
 
-void SetSphereVertices(float radius, unsigned int rings, unsigned int sectors)
+// Cancels the build that's still running, the newest request always wins
+std::shared_ptr<MeshBuildJob> StartMeshBuild()
 {
-	std::vector<float> vertices_;
-	std::vector<float> normals;
-	std::vector<float> texCoords;
-
-	float x, y, z, xy;                              // vertex position
-	float nx, ny, nz, lengthInv = 1.0f / radius;    // vertex normal
-	float s, t;                                     // vertex texCoord
+	if (pendingMeshBuild)
+		pendingMeshBuild->Cancel();
+	pendingMeshBuild = MeshBuildJob::Create(finishedMeshBuilds, meshSettings);
+	return pendingMeshBuild;
+}
 
-	float sectorStep = 2 * PI / sectors;
-	float stackStep = PI / rings;
-	float sectorAngle, stackAngle;
+// These return immediately, the mesh changes once the workers are done
+void SetSurfaceVertices(ParametricSurface::Type type, unsigned int rings, unsigned int sectors)
+{
+	ParametricSurface::GenerateLodsAsync(meshWorkers, ParametricSurface::CreateLodChain(type, rings, sectors), StartMeshBuild());
+}
 
-	for (int i = 0; i <= rings; ++i)
-	{
-		stackAngle = PI / 2 - i * stackStep;        // starting from pi/2 to -pi/2
-		xy = radius * cosf(stackAngle);             // r * cos(u)
-		z = radius * sinf(stackAngle);              // r * sin(u)
+void SetPyramidVertices()
+{
+	StartMeshBuild()->Run(meshWorkers, MakePyramidData);
+}
 
-		// add (sectorCount+1) vertices per stack
-		// the first and last vertices have same position and normal, but different tex coords
-		for (int j = 0; j <= sectors; ++j)
-		{
-			sectorAngle = j * sectorStep;           // starting from 0 to 2pi
-
-			// vertex position (x, y, z)
-			x = xy * cosf(sectorAngle);             // r * cos(u) * cos(v)
-			y = xy * sinf(sectorAngle);             // r * cos(u) * sin(v)
-			vertices_.push_back(x);
-			vertices_.push_back(y);
-			vertices_.push_back(z);
-
-			// normalized vertex normal (nx, ny, nz)
-			nx = x * lengthInv;
-			ny = y * lengthInv;
-			nz = z * lengthInv;
-			normals.push_back(nx);
-			normals.push_back(ny);
-			normals.push_back(nz);
-
-			// vertex tex coord (s, t) range between [0, 1]
-			s = (float)j / sectors;
-			t = (float)i / rings;
-			texCoords.push_back(s);
-			texCoords.push_back(t);
-		}
-	}
+void SetCubeVertices()
+{
+	StartMeshBuild()->Run(meshWorkers, MakeCubeData);
+}
 
-	int j = 0;
-	vertices.clear();
-	for (int i = 0; i < vertices_.size(); i += 3, j += 2)
-		vertices.push_back(Vertex{
-			glm::vec3(vertices_[i], vertices_[i + 1], vertices_[i + 2]),
-			glm::vec2(texCoords[j], texCoords[j + 1]),
-			glm::vec3(normals[i], normals[i + 1], normals[i + 2])
-			});
-
-	indices.clear();
-	int k1, k2;
-	for (int i = 0; i < rings; ++i)
+void SwapInFinishedMesh()
+{
+	std::shared_ptr<MeshBuildJob> job;
+	while (finishedMeshBuilds.TryPop(job))
 	{
-		k1 = i * (sectors + 1);     // beginning of current stack
-		k2 = k1 + sectors + 1;      // beginning of next stack
-
-		for (int j = 0; j < sectors; ++j, ++k1, ++k2)
-		{
-			// 2 triangles per sector excluding first and last stacks
-			// k1 => k2 => k1+1
-			if (i != 0)
-			{
-				indices.push_back(k1);
-				indices.push_back(k2);
-				indices.push_back(k1 + 1);
-			}
-
-			// k1+1 => k2 => k2+1
-			if (i != (rings - 1))
-			{
-				indices.push_back(k1 + 1);
-				indices.push_back(k2);
-				indices.push_back(k2 + 1);
-			}
-
-		}
+		if (job->IsCancelled())
+			continue;
+
+		// Reuses the back mesh's buffers when there is one
+		if (backMesh)
+			backMesh->Update(std::move(job->GetResult()));
+		else
+			backMesh = new Mesh(std::move(job->GetResult()), nullptr, meshSettings);
+		backMesh->texture = mesh->texture;
+		std::swap(mesh, backMesh);
+
+		lastBuildTime = job->GetBuildTime();
+		if (job == pendingMeshBuild)
+			pendingMeshBuild.reset();
 	}
-
-	delete mesh;
-	mesh = new Mesh(vertices, indices);
 }
 
-void SetCubeVertices()
+MeshData MakeCubeData()
 {
-	vertices =
+	MeshData data;
+	data.vertices =
 	{
 		// Left
 		Vertex{glm::vec3(-1, -1	, -1), glm::vec2(0, 0), glm::vec3(0, 0, -1)},
@@ -423,15 +569,13 @@ void SetCubeVertices()
 		Vertex{glm::vec3(1, -1, -1), glm::vec2(1, 0), glm::vec3(0, -1, 0)},
 	};
 
-	indices.clear();
-
-	for (unsigned int i = 0; i < 36; i += 4)
+	// 6 faces of 4 vertices, two triangles each
+	for (unsigned int i = 0; i < 24; i += 4)
 	{
-		indices.insert(indices.end(), { i, i + 1, i + 2 });
-		indices.insert(indices.end(), { i, i + 2, i + 3 });
+		data.indices.insert(data.indices.end(), { i, i + 1, i + 2 });
+		data.indices.insert(data.indices.end(), { i, i + 2, i + 3 });
 	}
 
 
-	delete mesh;
-	mesh = new Mesh(vertices, indices);
+	return data;
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "CameraUniformBlock.h"
+#include "GLStateCache.h"
+
+CameraUniformBlock::CameraUniformBlock()
+{
+	m_ID = UniqueBuffer::Create();
+	GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, m_ID.Get());
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraData), nullptr, GL_DYNAMIC_DRAW);
+	GLStateCache::BindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, m_ID.Get());
+}
+
+void CameraUniformBlock::Attach(Shader& shader)
+{
+	shader.BindUniformBlock("Camera", BINDING_POINT);
+}
+
+void CameraUniformBlock::Upload(const Camera& camera)
+{
+	if (m_Uploaded && camera.GetVersion() == m_UploadedVersion)
+		return;
+
+	CameraData data;
+	data.view = camera.GetView();
+	data.projection = camera.GetProjection();
+	data.viewProjection = camera.GetViewProjection();
+	data.position = glm::vec4(camera.GetPosition(), 1.f);
+
+	GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, m_ID.Get());
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraData), &data);
+
+	m_UploadedVersion = camera.GetVersion();
+	m_Uploaded = true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <GL/glew.h>
+#include "shader.h"
+#include "camera.h"
+
+/// <summary>
+/// std140 uniform buffer with the "Camera" block shared by every shader.
+/// Upload is called once per frame and only sends the matrices when the camera changed since the last upload.
+/// The buffer is bound to BINDING_POINT, so draws don't set any camera uniforms
+/// </summary>
+class CameraUniformBlock
+{
+public:
+	static const unsigned int BINDING_POINT = 1;
+private:
+	// Matches "uniform Camera" of the shaders in std140 layout
+	struct CameraData
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::mat4 viewProjection;
+		glm::vec4 position;
+	};
+	static_assert(sizeof(CameraData) == 208, "CameraData must match the std140 block size");
+
+	UniqueBuffer m_ID;
+	unsigned int m_UploadedVersion = 0;
+	bool m_Uploaded = false;
+public:
+	CameraUniformBlock();
+
+	void Attach(Shader& shader);
+	void Upload(const Camera& camera);
+};
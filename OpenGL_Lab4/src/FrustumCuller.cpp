@@ -0,0 +1,152 @@
+#include "FrustumCuller.h"
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_CULLER_SSE
+#include <xmmintrin.h>
+#endif
+
+FrustumCuller::FrustumCuller()
+{
+	SetViewProjection(glm::mat4(1.f));
+}
+
+// Gribb/Hartmann: every plane is the last row of the matrix plus or minus one of the others
+void FrustumCuller::SetViewProjection(const glm::mat4& viewProjection)
+{
+	glm::vec4 rows[4];
+	for (int row = 0; row < 4; row++)
+		rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		m_Planes[axis * 2] = rows[3] + rows[axis];
+		m_Planes[axis * 2 + 1] = rows[3] - rows[axis];
+	}
+	for (glm::vec4& plane : m_Planes)
+		plane /= glm::length(glm::vec3(plane));
+}
+
+void FrustumCuller::Clear()
+{
+	m_Count = 0;
+	m_VisibleCount = 0;
+}
+
+size_t FrustumCuller::Add(const AxisAlignedBox& box, const glm::mat4& model)
+{
+	size_t index = m_Count++;
+	size_t padded = (m_Count + 3) & ~(size_t)3;
+	if (m_CenterX.size() < padded)
+	{
+		for (std::vector<float>* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+			array->resize(padded);
+	}
+
+	// The extent of the transformed box is the extent projected on the absolute basis vectors
+	glm::vec3 center = glm::vec3(model * glm::vec4((box.min + box.max) * 0.5f, 1.f));
+	glm::vec3 halfSize = (box.max - box.min) * 0.5f;
+	glm::mat3 basis = glm::mat3(model);
+	glm::vec3 extent = glm::abs(basis[0]) * halfSize.x + glm::abs(basis[1]) * halfSize.y + glm::abs(basis[2]) * halfSize.z;
+
+	m_CenterX[index] = center.x;
+	m_CenterY[index] = center.y;
+	m_CenterZ[index] = center.z;
+	m_ExtentX[index] = extent.x;
+	m_ExtentY[index] = extent.y;
+	m_ExtentZ[index] = extent.z;
+	return index;
+}
+
+// A box is outside when it's fully behind one plane: dot(n, center) + w + dot(|n|, extent) < 0
+void FrustumCuller::Cull()
+{
+	m_Visible.resize(m_CenterX.size());
+	m_VisibleCount = 0;
+
+#ifdef FRUSTUM_CULLER_SSE
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+	for (int p = 0; p < 6; p++)
+	{
+		planeX[p] = _mm_set1_ps(m_Planes[p].x);
+		planeY[p] = _mm_set1_ps(m_Planes[p].y);
+		planeZ[p] = _mm_set1_ps(m_Planes[p].z);
+		planeW[p] = _mm_set1_ps(m_Planes[p].w);
+		absX[p] = _mm_set1_ps(std::abs(m_Planes[p].x));
+		absY[p] = _mm_set1_ps(std::abs(m_Planes[p].y));
+		absZ[p] = _mm_set1_ps(std::abs(m_Planes[p].z));
+	}
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t i = 0; i < m_Count; i += 4)
+	{
+		__m128 centerX = _mm_loadu_ps(&m_CenterX[i]);
+		__m128 centerY = _mm_loadu_ps(&m_CenterY[i]);
+		__m128 centerZ = _mm_loadu_ps(&m_CenterZ[i]);
+		__m128 extentX = _mm_loadu_ps(&m_ExtentX[i]);
+		__m128 extentY = _mm_loadu_ps(&m_ExtentY[i]);
+		__m128 extentZ = _mm_loadu_ps(&m_ExtentZ[i]);
+
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+		for (int p = 0; p < 6; p++)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(centerX, planeX[p]), _mm_mul_ps(centerY, planeY[p])),
+				_mm_add_ps(_mm_mul_ps(centerZ, planeZ[p]), planeW[p]));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extentX, absX[p]), _mm_mul_ps(extentY, absY[p])), _mm_mul_ps(extentZ, absZ[p]));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; lane++)
+			m_Visible[i + lane] = (uint8_t)((mask >> lane) & 1);
+	}
+#else
+	for (size_t i = 0; i < m_Count; i++)
+	{
+		bool inside = true;
+		for (int p = 0; p < 6 && inside; p++)
+		{
+			const glm::vec4& plane = m_Planes[p];
+			float distance = m_CenterX[i] * plane.x + m_CenterY[i] * plane.y + m_CenterZ[i] * plane.z + plane.w;
+			float radius = m_ExtentX[i] * std::abs(plane.x) + m_ExtentY[i] * std::abs(plane.y) + m_ExtentZ[i] * std::abs(plane.z);
+			inside = distance + radius >= 0.f;
+		}
+		m_Visible[i] = inside;
+	}
+#endif
+
+	for (size_t i = 0; i < m_Count; i++)
+		m_VisibleCount += m_Visible[i];
+}
+
+CullBenchmark FrustumCuller::MeasureCull(size_t objectCount)
+{
+	const int RUNS = 5;
+	FrustumCuller culler;
+	culler.SetViewProjection(glm::perspective(glm::radians(90.f), 1.f, 0.1f, 1000.f) *
+		glm::lookAt(glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f)));
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-100.f, 100.f), size(0.1f, 1.f);
+	for (size_t i = 0; i < objectCount; i++)
+	{
+		glm::vec3 center(position(random), position(random), position(random));
+		glm::vec3 halfSize(size(random), size(random), size(random));
+		culler.Add({ center - halfSize, center + halfSize });
+	}
+
+	CullBenchmark result;
+	auto start = std::chrono::steady_clock::now();
+	for (int run = 0; run < RUNS; run++)
+		culler.Cull();
+	double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / RUNS;
+
+	result.objects = objectCount;
+	result.visible = culler.GetVisibleCount();
+	result.milliseconds = nanoseconds / 1e6;
+	result.nanosecondsPerObject = objectCount > 0 ? nanoseconds / objectCount : 0.0;
+	return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+struct CullBenchmark
+{
+	size_t objects = 0;
+	size_t visible = 0;
+	double milliseconds = 0.0;
+	double nanosecondsPerObject = 0.0;
+};
+
+/// <summary>
+/// Tests world space boxes against the six planes of a view-projection matrix.
+/// Boxes are stored as center and extent in separate arrays (structure of arrays),
+/// so the SSE path tests 4 objects per iteration with one plane broadcast per register
+/// </summary>
+class FrustumCuller
+{
+private:
+	// xyz is the normal pointing inside the frustum, w the distance. Normalised, so distances are in world units
+	glm::vec4 m_Planes[6];
+	// Padded to a multiple of 4, the padding results are ignored
+	std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+	std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+	std::vector<uint8_t> m_Visible;
+	size_t m_Count = 0;
+	size_t m_VisibleCount = 0;
+public:
+	FrustumCuller();
+
+	void SetViewProjection(const glm::mat4& viewProjection);
+	// Drops the boxes, keeps the storage
+	void Clear();
+	// Transforms the box to world space, the returned index is passed to IsVisible after Cull
+	size_t Add(const AxisAlignedBox& box, const glm::mat4& model = glm::mat4(1.f));
+	void Cull();
+
+	inline bool IsVisible(size_t index) const { return m_Visible[index] != 0; }
+	inline size_t GetCount() const { return m_Count; }
+	inline size_t GetVisibleCount() const { return m_VisibleCount; }
+
+	// Culls objectCount random boxes around a camera at the origin and times the Cull call
+	static CullBenchmark MeasureCull(size_t objectCount);
+};
@@ -1,16 +1,44 @@
 #include "LightCube.h"
+#include <glm/gtc/matrix_transform.hpp>
 
-LightCube::LightCube(glm::vec3 color, int lightIndex, Shader *lightShader, Shader *litObjectShader)
+MeshData LightCube::MakeGizmoData()
+{
+	MeshData data;
+	data.vertices =
+	{
+		Vertex{glm::vec3(-0.1f, -0.1f,  0.1f)},
+		Vertex{glm::vec3(-0.1f, -0.1f, -0.1f)},
+		Vertex{glm::vec3(0.1f, -0.1f, -0.1f)},
+		Vertex{glm::vec3(0.1f, -0.1f,  0.1f)},
+		Vertex{glm::vec3(-0.1f,  0.1f,  0.1f)},
+		Vertex{glm::vec3(-0.1f,  0.1f, -0.1f)},
+		Vertex{glm::vec3(0.1f,  0.1f, -0.1f)},
+		Vertex{glm::vec3(0.1f,  0.1f,  0.1f)}
+	};
+	data.indices =
+	{
+		0, 1, 2,
+		0, 2, 3,
+		0, 4, 7,
+		0, 7, 3,
+		3, 7, 6,
+		3, 6, 2,
+		2, 6, 5,
+		2, 5, 1,
+		1, 5, 4,
+		1, 4, 0,
+		4, 5, 6,
+		4, 6, 7
+	};
+	return data;
+}
+
+LightCube::LightCube(glm::vec3 color, int lightIndex, LightUniformBlock* litObjectLights)
 {
 	this->color = color;
-	m_LightShader = lightShader;
-	m_LitObjectShader = litObjectShader;
+	m_LitObjectLights = litObjectLights;
 	m_LightIndex = lightIndex;
 
-	vertices = m_CubeVertices;
-	indices = m_CubeIndices;
-	SetVAO();
-
 	// Refresh shaders
 	Move(0, 0, 0);
 	SetColor(color);
@@ -21,13 +49,7 @@ void LightCube::Move(float x, float y, float z, bool addToPreviousPosition)
 {
 	lightPosition = addToPreviousPosition ? lightPosition + glm::vec3(x, y, z) : glm::vec3(x, y, z);
 	m_ModelMatrix = glm::translate(glm::mat4(1.0f), lightPosition);
-
-	m_LightShader->Bind();
-	m_LightShader->SetUniformMat4f("model", m_ModelMatrix);
-
-	m_LitObjectShader->Bind();
-	m_LitObjectShader->SetUniform3f("lights[" + std::to_string(m_LightIndex) + "].position", lightPosition);
-	m_LitObjectShader->Unbind();
+	m_LitObjectLights->SetPosition(m_LightIndex, lightPosition);
 }
 
 
@@ -35,22 +57,17 @@ void LightCube::Move(float x, float y, float z, bool addToPreviousPosition)
 void LightCube::SetColor(glm::vec3 color)
 {
 	this->color = color;
-
-	m_LightShader->Bind();
-	m_LightShader->SetUniform3f("lightColor", color);
-
-	m_LitObjectShader->Bind();
-	m_LitObjectShader->SetUniform3f("lights[" + std::to_string(m_LightIndex) + "].color", color);
-	m_LitObjectShader->Unbind();
+	m_LitObjectLights->SetColor(m_LightIndex, color);
 }
 
 
 void LightCube::SetIntencity(float m_Intencity)
 {
 	this->m_Intencity = m_Intencity;
-	m_LitObjectShader->Bind();
-	m_LitObjectShader->SetUniform1f("lights[" + std::to_string(m_LightIndex) + "].intencity", m_Intencity);
-	m_LitObjectShader->Unbind();
+	m_LitObjectLights->SetIntencity(m_LightIndex, m_Intencity);
 }
 
-void LightCube::Render(Camera& camera) { Mesh::Render(*m_LightShader, camera); }
\ No newline at end of file
+void LightCube::AddGizmo(InstancedMesh& gizmos) const
+{
+	gizmos.Add(m_ModelMatrix, glm::vec4(color, 1.f));
+}
@@ -0,0 +1,94 @@
+#include "LightUniformBlock.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+LightUniformBlock::LightUniformBlock(int maxLights)
+{
+	// GL guarantees at least 16 KiB, the query leaves it untouched without a context
+	GLint maxBlockSize = 16384;
+	glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &maxBlockSize);
+	m_MaxLights = std::max(1, std::min(maxLights, (int)(std::max<GLint>(maxBlockSize - (GLint)LIGHTS_OFFSET, 0) / sizeof(LightData))));
+
+	m_Data.assign(LIGHTS_OFFSET + m_MaxLights * sizeof(LightData), 0);
+	m_DirtyBegin = m_Data.size();
+	m_DirtyEnd = 0;
+
+	m_ID = UniqueBuffer::Create();
+	GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, m_ID.Get());
+	glBufferData(GL_UNIFORM_BUFFER, m_Data.size(), m_Data.data(), GL_DYNAMIC_DRAW);
+	GLStateCache::BindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, m_ID.Get());
+}
+
+void LightUniformBlock::Attach(Shader& shader)
+{
+	shader.BindUniformBlock("Lights", BINDING_POINT);
+}
+
+LightUniformBlock::LightData& LightUniformBlock::GetLight(int lightIndex)
+{
+	return *reinterpret_cast<LightData*>(&m_Data[LIGHTS_OFFSET + lightIndex * sizeof(LightData)]);
+}
+
+bool LightUniformBlock::IsValidLight(int lightIndex) const
+{
+	bool valid = lightIndex >= 0 && lightIndex < m_MaxLights;
+	assert(valid && "light index outside the uniform block");
+	return valid;
+}
+
+void LightUniformBlock::MarkDirty(size_t offset, size_t size)
+{
+	m_DirtyBegin = std::min(m_DirtyBegin, offset);
+	m_DirtyEnd = std::max(m_DirtyEnd, offset + size);
+}
+
+void LightUniformBlock::SetNumOfLights(int numOfLights)
+{
+	numOfLights = std::max(0, std::min(numOfLights, m_MaxLights));
+	*reinterpret_cast<int*>(&m_Data[0]) = numOfLights;
+	MarkDirty(0, sizeof(int));
+}
+
+int LightUniformBlock::GetNumOfLights() const
+{
+	return *reinterpret_cast<const int*>(&m_Data[0]);
+}
+
+void LightUniformBlock::SetPosition(int lightIndex, glm::vec3 position)
+{
+	if (!IsValidLight(lightIndex))
+		return;
+	GetLight(lightIndex).position = position;
+	MarkDirty(LIGHTS_OFFSET + lightIndex * sizeof(LightData) + offsetof(LightData, position), sizeof(glm::vec3));
+}
+
+void LightUniformBlock::SetColor(int lightIndex, glm::vec3 color)
+{
+	if (!IsValidLight(lightIndex))
+		return;
+	GetLight(lightIndex).color = color;
+	MarkDirty(LIGHTS_OFFSET + lightIndex * sizeof(LightData) + offsetof(LightData, color), sizeof(glm::vec3));
+}
+
+void LightUniformBlock::SetIntencity(int lightIndex, float intencity)
+{
+	if (!IsValidLight(lightIndex))
+		return;
+	GetLight(lightIndex).intencity = intencity;
+	MarkDirty(LIGHTS_OFFSET + lightIndex * sizeof(LightData) + offsetof(LightData, intencity), sizeof(float));
+}
+
+// Sends everything changed since the last upload as a single range
+void LightUniformBlock::Upload()
+{
+	if (m_DirtyBegin >= m_DirtyEnd)
+		return;
+
+	GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, m_ID.Get());
+	glBufferSubData(GL_UNIFORM_BUFFER, m_DirtyBegin, m_DirtyEnd - m_DirtyBegin, &m_Data[m_DirtyBegin]);
+
+	m_DirtyBegin = m_Data.size();
+	m_DirtyEnd = 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include "shader.h"
+
+/// <summary>
+/// std140 uniform buffer with the "Lights" block of the lit shaders.
+/// Setters only write to a CPU-side copy, Upload sends the changed bytes with one glBufferSubData per frame.
+/// The buffer is bound to BINDING_POINT, so it is shared by every program attached with Attach
+/// </summary>
+class LightUniformBlock
+{
+public:
+	static const unsigned int BINDING_POINT = 0;
+private:
+	// Matches "struct BasicLight" of lit.shader in std140 layout
+	struct LightData
+	{
+		glm::vec3 position;
+		float intencity;
+		glm::vec3 color;
+		float padding;
+	};
+	static_assert(sizeof(LightData) == 32, "LightData must match the std140 array stride");
+	// numOfLights is padded to the 16 byte alignment of the lights array
+	static const size_t LIGHTS_OFFSET = 16;
+
+	UniqueBuffer m_ID;
+	int m_MaxLights;
+	std::vector<unsigned char> m_Data;
+	size_t m_DirtyBegin;
+	size_t m_DirtyEnd;
+
+	LightData& GetLight(int lightIndex);
+	// Asserts in debug builds, the setters ignore writes to lights past GetMaxLights
+	bool IsValidLight(int lightIndex) const;
+	void MarkDirty(size_t offset, size_t size);
+public:
+	LightUniformBlock(int maxLights);
+
+	// The number of lights may be clamped by GL_MAX_UNIFORM_BLOCK_SIZE
+	inline int GetMaxLights() const { return m_MaxLights; }
+	int GetNumOfLights() const;
+	void Attach(Shader& shader);
+
+	void SetNumOfLights(int numOfLights);
+	void SetPosition(int lightIndex, glm::vec3 position);
+	void SetColor(int lightIndex, glm::vec3 color);
+	void SetIntencity(int lightIndex, float intencity);
+
+	void Upload();
+};
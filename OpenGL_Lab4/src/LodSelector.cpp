@@ -0,0 +1,41 @@
+#include "LodSelector.h"
+
+#include <algorithm>
+#include <cmath>
+
+float LodSelector::GetPixelsPerUnit(const Camera& camera, const BoundingSphere& bounds)
+{
+	float distance = std::max(glm::distance(camera.GetPosition(), bounds.center) - bounds.radius, camera.GetNearPlane());
+	return camera.GetHeight() / (2.f * std::tan(glm::radians(camera.GetFovDeg()) * 0.5f) * distance);
+}
+
+void LodSelector::Update(Mesh& mesh, const Camera& camera)
+{
+	m_Frame++;
+	float pixelsPerUnit = GetPixelsPerUnit(camera, mesh.GetBounds());
+	size_t current = mesh.GetCurrentLod();
+
+	// Levels are ordered by increasing error, so the coarsest one under the limit is the cheapest
+	auto coarsestUnder = [&mesh, pixelsPerUnit](float limit)
+	{
+		size_t lod = 0;
+		while (lod + 1 < mesh.GetLodCount() && mesh.GetLod(lod + 1).geometricError * pixelsPerUnit <= limit)
+			lod++;
+		return lod;
+	};
+
+	size_t selected = current;
+	if (mesh.GetLod(current).geometricError * pixelsPerUnit > maxScreenError * (1.f + hysteresis))
+		selected = coarsestUnder(maxScreenError);
+	else
+		selected = std::max(current, coarsestUnder(maxScreenError * (1.f - hysteresis)));
+
+	if (selected != current)
+	{
+		mesh.SetLod(selected);
+		m_Transitions.push_front({ m_Frame, current, selected, mesh.GetLod(selected).geometricError * pixelsPerUnit });
+		if (m_Transitions.size() > MAX_LOGGED_TRANSITIONS)
+			m_Transitions.pop_back();
+	}
+	m_ScreenError = mesh.GetLod(selected).geometricError * pixelsPerUnit;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <deque>
+
+#include "Mesh.h"
+#include "camera.h"
+
+struct LodTransition
+{
+	unsigned long long frame;
+	size_t from;
+	size_t to;
+	// Of the new level, in pixels
+	float screenError;
+};
+
+/// <summary>
+/// Picks the cheapest level of detail whose geometric error, projected on the screen, stays under maxScreenError.
+/// A level is only left once its error crossed the threshold by the hysteresis band, so it doesn't flicker at the boundary
+/// </summary>
+class LodSelector
+{
+private:
+	std::deque<LodTransition> m_Transitions;
+	unsigned long long m_Frame = 0;
+	float m_ScreenError = 0.f;
+
+	static constexpr size_t MAX_LOGGED_TRANSITIONS = 8;
+public:
+	// In pixels
+	float maxScreenError = 1.f;
+	// Fraction of maxScreenError an error has to cross before the level changes
+	float hysteresis = 0.25f;
+
+	// Selects and sets the mesh's level, call once per frame
+	void Update(Mesh& mesh, const Camera& camera);
+
+	// Size on screen of one model unit at the point of the bounds closest to the camera
+	static float GetPixelsPerUnit(const Camera& camera, const BoundingSphere& bounds);
+
+	// Error of the current level, in pixels
+	inline float GetScreenError() const { return m_ScreenError; }
+	// Last transitions, newest first
+	inline const std::deque<LodTransition>& GetTransitions() const { return m_Transitions; }
+};
@@ -0,0 +1,34 @@
+#include "MeshBuildJob.h"
+
+MeshBuildJob::MeshBuildJob(Queue& completed, const MeshSettings& settings)
+	: m_Completed(completed), m_Settings(settings), m_StartTime(std::chrono::steady_clock::now())
+{
+}
+
+std::shared_ptr<MeshBuildJob> MeshBuildJob::Create(Queue& completed, const MeshSettings& settings)
+{
+	return std::make_shared<MeshBuildJob>(completed, settings);
+}
+
+void MeshBuildJob::Run(ThreadPool& pool, std::function<MeshData()> generate)
+{
+	std::shared_ptr<MeshBuildJob> job = shared_from_this();
+	pool.Submit([job, generate]()
+	{
+		if (!job->IsCancelled())
+			job->Complete(generate());
+	});
+}
+
+void MeshBuildJob::Complete(MeshData data)
+{
+	if (IsCancelled())
+		return;
+	m_Result = MeshStaging::Prepare(std::move(data), m_Settings);
+	m_BuildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartTime).count();
+	m_Done.store(true, std::memory_order_release);
+
+	// Checked again by the render thread, the job may be cancelled after this
+	if (!IsCancelled())
+		m_Completed.Push(shared_from_this());
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include "Mesh.h"
+#include "threadPool.h"
+#include "completionQueue.h"
+
+/// <summary>
+/// Builds a mesh's staging data off the render thread: generation, optimisation and packing.
+/// Finished jobs are pushed to a completion queue, the render thread only uploads the result
+/// </summary>
+class MeshBuildJob : public std::enable_shared_from_this<MeshBuildJob>
+{
+public:
+	using Queue = CompletionQueue<std::shared_ptr<MeshBuildJob>>;
+private:
+	Queue& m_Completed;
+	MeshSettings m_Settings;
+	MeshStaging m_Result;
+	std::atomic<bool> m_Cancelled{ false };
+	std::atomic<bool> m_Done{ false };
+	std::chrono::steady_clock::time_point m_StartTime;
+	double m_BuildTime = 0.0;
+public:
+	// Use Create, jobs are shared between the workers and the render thread
+	MeshBuildJob(Queue& completed, const MeshSettings& settings);
+	static std::shared_ptr<MeshBuildJob> Create(Queue& completed, const MeshSettings& settings);
+
+	// Generates the geometry with a single task on the pool
+	void Run(ThreadPool& pool, std::function<MeshData()> generate);
+	// Called by the worker that produced the geometry (see ParametricSurface::GenerateAsync).
+	// Prepares the staging data and hands the job to the render thread unless it was cancelled
+	void Complete(MeshData data);
+
+	// Generators poll IsCancelled and stop early, a cancelled job is never completed
+	inline void Cancel() { m_Cancelled.store(true, std::memory_order_relaxed); }
+	inline bool IsCancelled() const { return m_Cancelled.load(std::memory_order_relaxed); }
+	inline bool IsDone() const { return m_Done.load(std::memory_order_acquire); }
+
+	// Only valid once the job was popped from the completion queue
+	inline MeshStaging& GetResult() { return m_Result; }
+	// Milliseconds from creation until the staging data was ready
+	inline double GetBuildTime() const { return m_BuildTime; }
+};
@@ -0,0 +1,391 @@
+#include "ParametricSurface.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <glm/gtc/constants.hpp>
+
+ParametricSurface::ParametricSurface(unsigned int rings, unsigned int sectors)
+	: m_Rings(std::max(rings, 1u)), m_Sectors(std::max(sectors, 3u))
+{
+	m_SectorRotations.resize(m_Sectors + 1);
+	FillRotations(m_SectorRotations.data(), m_SectorRotations.size(), 0.0, 2.0 * glm::pi<double>() / m_Sectors);
+}
+
+void ParametricSurface::FillRotations(glm::vec2* out, size_t count, double startAngle, double step)
+{
+	// Accumulated in double, the drift over thousands of steps stays far below float precision
+	double c = cos(startAngle), s = sin(startAngle);
+	double stepCos = cos(step), stepSin = sin(step);
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = glm::vec2((float)c, (float)s);
+		double next = c * stepCos - s * stepSin;
+		s = s * stepCos + c * stepSin;
+		c = next;
+	}
+}
+
+// Triangles whose two corners lie on a collapsed ring (a pole or an apex) are degenerate and skipped
+bool ParametricSurface::IsCollapsed(unsigned int ring) const
+{
+	return !m_Profile.empty() && m_Profile[ring].radius == 0.f;
+}
+
+void ParametricSurface::Finish()
+{
+	m_RingIndexOffsets.resize(m_Rings + 1);
+	m_RingIndexOffsets[0] = 0;
+	for (unsigned int ring = 0; ring < m_Rings; ring++)
+	{
+		size_t triangles = (IsCollapsed(ring) ? 0 : m_Sectors) + (IsCollapsed(ring + 1) ? 0 : m_Sectors);
+		m_RingIndexOffsets[ring + 1] = m_RingIndexOffsets[ring] + triangles * 3;
+	}
+}
+
+ParametricSurface ParametricSurface::Sphere(float radius, unsigned int rings, unsigned int sectors)
+{
+	ParametricSurface surface(rings, sectors);
+	std::vector<glm::vec2> stacks(surface.m_Rings + 1);
+	// From the north pole (pi/2) to the south one (-pi/2)
+	FillRotations(stacks.data(), stacks.size(), glm::half_pi<double>(), -glm::pi<double>() / surface.m_Rings);
+
+	surface.m_Profile.resize(surface.m_Rings + 1);
+	for (unsigned int ring = 0; ring <= surface.m_Rings; ring++)
+		surface.m_Profile[ring] = { radius * stacks[ring].x, radius * stacks[ring].y, stacks[ring].x, stacks[ring].y };
+	surface.m_Profile.front() = { 0.f, radius, 0.f, 1.f };
+	surface.m_Profile.back() = { 0.f, -radius, 0.f, -1.f };
+
+	surface.Finish();
+	return surface;
+}
+
+ParametricSurface ParametricSurface::Torus(float majorRadius, float minorRadius, unsigned int rings, unsigned int sectors)
+{
+	ParametricSurface surface(rings, sectors);
+	std::vector<glm::vec2> tube(surface.m_Rings + 1);
+	// Around the tube from its top over the outer side, so the winding matches the sphere
+	FillRotations(tube.data(), tube.size(), glm::half_pi<double>(), -2.0 * glm::pi<double>() / surface.m_Rings);
+
+	surface.m_Profile.resize(surface.m_Rings + 1);
+	for (unsigned int ring = 0; ring <= surface.m_Rings; ring++)
+		surface.m_Profile[ring] = { majorRadius + minorRadius * tube[ring].x, minorRadius * tube[ring].y, tube[ring].x, tube[ring].y };
+
+	surface.Finish();
+	return surface;
+}
+
+ParametricSurface ParametricSurface::Cylinder(float radius, float height, unsigned int rings, unsigned int sectors)
+{
+	ParametricSurface surface(rings, sectors);
+	surface.m_Profile.resize(surface.m_Rings + 1);
+	for (unsigned int ring = 0; ring <= surface.m_Rings; ring++)
+		surface.m_Profile[ring] = { radius, height * (0.5f - (float)ring / surface.m_Rings), 1.f, 0.f };
+
+	surface.Finish();
+	return surface;
+}
+
+ParametricSurface ParametricSurface::Cone(float radius, float height, unsigned int rings, unsigned int sectors)
+{
+	ParametricSurface surface(rings, sectors);
+	float slant = sqrtf(radius * radius + height * height);
+	surface.m_Profile.resize(surface.m_Rings + 1);
+	for (unsigned int ring = 0; ring <= surface.m_Rings; ring++)
+	{
+		float t = (float)ring / surface.m_Rings;
+		surface.m_Profile[ring] = { radius * t, height * (0.5f - t), height / slant, radius / slant };
+	}
+
+	surface.Finish();
+	return surface;
+}
+
+ParametricSurface ParametricSurface::Hyperboloid(float a, float c, float height, unsigned int rings, unsigned int sectors)
+{
+	ParametricSurface surface(rings, sectors);
+	surface.m_Profile.resize(surface.m_Rings + 1);
+	for (unsigned int ring = 0; ring <= surface.m_Rings; ring++)
+	{
+		float z = height * (0.5f - (float)ring / surface.m_Rings);
+		float radius = a * sqrtf(1.f + z * z / (c * c));
+		// Gradient of the implicit equation, projected to the profile plane
+		glm::vec2 normal = glm::normalize(glm::vec2(radius / (a * a), -z / (c * c)));
+		surface.m_Profile[ring] = { radius, z, normal.x, normal.y };
+	}
+
+	surface.Finish();
+	return surface;
+}
+
+ParametricSurface ParametricSurface::FromFunction(unsigned int rings, unsigned int sectors, VertexFunction function)
+{
+	ParametricSurface surface(rings, sectors);
+	surface.m_Function = function;
+	surface.Finish();
+	return surface;
+}
+
+ParametricSurface ParametricSurface::Create(Type type, unsigned int rings, unsigned int sectors)
+{
+	switch (type)
+	{
+	case Type::Torus: return Torus(0.4f, 0.15f, rings, sectors);
+	case Type::Cylinder: return Cylinder(0.4f, 1.f, rings, sectors);
+	case Type::Cone: return Cone(0.5f, 1.f, rings, sectors);
+	case Type::Hyperboloid: return Hyperboloid(0.25f, 0.3f, 1.f, rings, sectors);
+	default: return Sphere(0.5f, rings, sectors);
+	}
+}
+
+std::vector<ParametricSurface> ParametricSurface::CreateLodChain(Type type, unsigned int rings, unsigned int sectors, unsigned int maxLevels)
+{
+	std::vector<ParametricSurface> levels;
+	for (unsigned int level = 0; level < maxLevels; level++)
+	{
+		unsigned int levelRings = std::max(rings >> level, 3u), levelSectors = std::max(sectors >> level, 3u);
+		if (level > 0 && levels.back().m_Rings == levelRings && levels.back().m_Sectors == levelSectors)
+			break;
+		levels.push_back(Create(type, levelRings, levelSectors));
+	}
+	return levels;
+}
+
+// Sizes the arrays for all levels and lays them out one after another
+MeshData ParametricSurface::AllocateLods(const std::vector<ParametricSurface>& levels)
+{
+	MeshData data;
+	size_t vertexCount = 0, indexCount = 0;
+	for (const ParametricSurface& level : levels)
+	{
+		MeshLod lod;
+		lod.firstIndex = indexCount;
+		lod.indexCount = (GLsizei)level.GetIndexCount();
+		lod.baseVertex = (GLint)vertexCount;
+		lod.vertexCount = (GLsizei)level.GetVertexCount();
+		data.lods.push_back(lod);
+		vertexCount += lod.vertexCount;
+		indexCount += lod.indexCount;
+	}
+	data.vertices.resize(vertexCount);
+	data.indices.resize(indexCount);
+	return data;
+}
+
+void ParametricSurface::MeasureLods(const std::vector<ParametricSurface>& levels, MeshData& data)
+{
+	for (size_t i = 0; i < levels.size(); i++)
+		data.lods[i].geometricError = levels[i].EstimateGeometricError(data.vertices.data() + data.lods[i].baseVertex);
+}
+
+// A curve segment whose samples have the second difference d bulges about |d| / 8 from its chord,
+// so the largest second difference along the grid bounds the error of the flat triangles
+float ParametricSurface::EstimateGeometricError(const Vertex* vertices) const
+{
+	size_t columns = m_Sectors + 1;
+	float error = 0.f;
+	for (unsigned int ring = 0; ring <= m_Rings; ring++)
+	{
+		for (unsigned int sector = 0; sector <= m_Sectors; sector++)
+		{
+			const Vertex* vertex = vertices + ring * columns + sector;
+			if (ring > 0 && ring < m_Rings)
+				error = std::max(error, glm::length((vertex - columns)->position - 2.f * vertex->position + (vertex + columns)->position));
+			if (sector > 0 && sector < m_Sectors)
+				error = std::max(error, glm::length((vertex - 1)->position - 2.f * vertex->position + (vertex + 1)->position));
+		}
+	}
+	return error / 8.f;
+}
+
+MeshData ParametricSurface::Generate() const
+{
+	return GenerateLods({ *this });
+}
+
+ParametricSurface::GenerateBenchmark ParametricSurface::MeasureGenerate(Type type, unsigned int rings, unsigned int sectors)
+{
+	auto start = std::chrono::steady_clock::now();
+	MeshData data = Create(type, rings, sectors).Generate();
+	GenerateBenchmark result;
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	result.vertices = data.vertices.size();
+	result.triangles = data.indices.size() / 3;
+	return result;
+}
+
+void ParametricSurface::GenerateAsync(ThreadPool& pool, std::shared_ptr<MeshBuildJob> job) const
+{
+	GenerateLodsAsync(pool, { *this }, std::move(job));
+}
+
+MeshData ParametricSurface::GenerateLods(const std::vector<ParametricSurface>& levels)
+{
+	MeshData data = AllocateLods(levels);
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		levels[i].FillVertices(data.vertices.data() + data.lods[i].baseVertex, 0, levels[i].m_Rings + 1);
+		levels[i].FillIndices(data.indices.data() + data.lods[i].firstIndex, 0, levels[i].m_Rings);
+	}
+	MeasureLods(levels, data);
+	return data;
+}
+
+void ParametricSurface::GenerateLodsAsync(ThreadPool& pool, std::vector<ParametricSurface> levels, std::shared_ptr<MeshBuildJob> job)
+{
+	// Shared by all ranges, keeps the surfaces alive after the caller's copies are gone
+	struct Generation
+	{
+		std::vector<ParametricSurface> levels;
+		std::shared_ptr<MeshBuildJob> job;
+		MeshData data;
+		std::atomic<unsigned int> remaining;
+
+		Generation(std::vector<ParametricSurface> levels, std::shared_ptr<MeshBuildJob> job)
+			: levels(std::move(levels)), job(std::move(job)), remaining(0) {}
+	};
+
+	auto generation = std::make_shared<Generation>(std::move(levels), std::move(job));
+	// Workers write straight into these, every range to its own span
+	generation->data = AllocateLods(generation->levels);
+
+	std::vector<unsigned int> ranges;
+	unsigned int rangeCount = 0;
+	for (const ParametricSurface& level : generation->levels)
+	{
+		ranges.push_back(level.GetRangeCount(pool.GetThreadCount()));
+		rangeCount += ranges.back();
+	}
+	generation->remaining = rangeCount;
+
+	for (size_t level = 0; level < ranges.size(); level++)
+	{
+		for (unsigned int i = 0; i < ranges[level]; i++)
+		{
+			pool.Submit([generation, level, i, count = ranges[level]]()
+			{
+				if (!generation->job->IsCancelled())
+				{
+					const MeshLod& lod = generation->data.lods[level];
+					generation->levels[level].FillRange(generation->data.vertices.data() + lod.baseVertex,
+						generation->data.indices.data() + lod.firstIndex, i, count);
+				}
+
+				// acq_rel makes the other ranges' writes visible to the worker completing the job
+				if (generation->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+					return;
+				if (!generation->job->IsCancelled())
+					MeasureLods(generation->levels, generation->data);
+				generation->job->Complete(std::move(generation->data));
+			});
+		}
+	}
+}
+
+// A few ranges per thread balance the uneven cost of collapsed rings
+unsigned int ParametricSurface::GetRangeCount(unsigned int threadCount) const
+{
+	return std::max(1u, std::min(m_Rings, threadCount * 4));
+}
+
+void ParametricSurface::FillRange(Vertex* vertices, GLuint* indices, unsigned int range, unsigned int rangeCount) const
+{
+	unsigned int rows = m_Rings + 1, bands = m_Rings;
+	FillVertices(vertices, rows * range / rangeCount, rows * (range + 1) / rangeCount);
+	FillIndices(indices, bands * range / rangeCount, bands * (range + 1) / rangeCount);
+}
+
+std::vector<ParametricSurface::ScalingBenchmark> ParametricSurface::MeasureScaling(Type type, unsigned int rings, unsigned int sectors,
+	unsigned int maxThreads)
+{
+	ParametricSurface surface = Create(type, rings, sectors);
+	MeshData data = AllocateLods({ surface });
+	// Touches every page first, so the first run doesn't pay for the page faults alone
+	surface.FillRange(data.vertices.data(), data.indices.data(), 0, 1);
+
+	std::vector<ScalingBenchmark> results;
+	for (unsigned int threads = 1; threads <= maxThreads; threads++)
+	{
+		unsigned int count = surface.GetRangeCount(threads);
+		std::atomic<unsigned int> remaining(count);
+		std::promise<void> done;
+		std::future<void> finished = done.get_future();
+		// Declared last, so its workers are joined before the state they use is destroyed
+		ThreadPool pool(threads);
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < count; i++)
+		{
+			pool.Submit([&surface, &data, &remaining, &done, i, count]()
+			{
+				surface.FillRange(data.vertices.data(), data.indices.data(), i, count);
+				if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					done.set_value();
+			});
+		}
+		finished.wait();
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		results.push_back({ threads, milliseconds, results.empty() ? 1.0 : results[0].milliseconds / milliseconds });
+	}
+	return results;
+}
+
+// Fills the vertex rows [ringBegin, ringEnd), there are rings + 1 of them
+void ParametricSurface::FillVertices(Vertex* vertices, unsigned int ringBegin, unsigned int ringEnd) const
+{
+	float ringStep = 1.f / m_Rings, sectorStep = 1.f / m_Sectors;
+	Vertex* out = vertices + (size_t)ringBegin * (m_Sectors + 1);
+	for (unsigned int ring = ringBegin; ring < ringEnd; ring++)
+	{
+		float u = ring * ringStep;
+		if (m_Function)
+		{
+			for (unsigned int sector = 0; sector <= m_Sectors; sector++, out++)
+			{
+				float v = sector * sectorStep;
+				out->texUV = glm::vec2(v, u);
+				m_Function(u, v, *out);
+			}
+			continue;
+		}
+
+		const ProfilePoint& profile = m_Profile[ring];
+		for (unsigned int sector = 0; sector <= m_Sectors; sector++, out++)
+		{
+			glm::vec2 rotation = m_SectorRotations[sector];
+			out->position = glm::vec3(profile.radius * rotation.x, profile.radius * rotation.y, profile.z);
+			out->texUV = glm::vec2(sector * sectorStep, u);
+			out->normal = glm::vec3(profile.normalRadius * rotation.x, profile.normalRadius * rotation.y, profile.normalZ);
+		}
+	}
+}
+
+// Fills the triangles between rings [ringBegin, ringEnd) and the next ones, there are rings bands
+void ParametricSurface::FillIndices(GLuint* indices, unsigned int ringBegin, unsigned int ringEnd) const
+{
+	GLuint* out = indices + m_RingIndexOffsets[ringBegin];
+	for (unsigned int ring = ringBegin; ring < ringEnd; ring++)
+	{
+		bool topCollapsed = IsCollapsed(ring), bottomCollapsed = IsCollapsed(ring + 1);
+		GLuint k1 = ring * (m_Sectors + 1);
+		GLuint k2 = k1 + m_Sectors + 1;
+		for (unsigned int sector = 0; sector < m_Sectors; sector++, k1++, k2++)
+		{
+			if (!topCollapsed)
+			{
+				*out++ = k1;
+				*out++ = k2;
+				*out++ = k1 + 1;
+			}
+			if (!bottomCollapsed)
+			{
+				*out++ = k1 + 1;
+				*out++ = k2;
+				*out++ = k2 + 1;
+			}
+		}
+	}
+}
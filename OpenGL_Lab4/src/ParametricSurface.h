@@ -0,0 +1,112 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "MeshBuildJob.h"
+#include "threadPool.h"
+
+/// <summary>
+/// Tessellates a surface into a (rings + 1) x (sectors + 1) vertex grid.
+/// Built-in shapes are surfaces of revolution: a profile curve evaluated once per ring,
+/// rotated around the z axis by a per-sector (cos, sin) table. Both are built with rotation
+/// recurrences, so the grid itself is filled without trigonometry and in one pass
+/// </summary>
+class ParametricSurface
+{
+public:
+	enum class Type { Sphere, Torus, Cylinder, Cone, Hyperboloid };
+
+	// Point of the profile curve in (distance from the axis, z) and its normal in the same plane
+	struct ProfilePoint
+	{
+		float radius;
+		float z;
+		float normalRadius;
+		float normalZ;
+	};
+
+	// Fills position and normal at (u, v) in [0, 1]. texUV is preset to (v, u) and may be overwritten
+	using VertexFunction = std::function<void(float u, float v, Vertex& vertex)>;
+
+	// Result of MeasureGenerate
+	struct GenerateBenchmark
+	{
+		size_t vertices;
+		size_t triangles;
+		double milliseconds;
+	};
+
+	// One run of MeasureScaling
+	struct ScalingBenchmark
+	{
+		unsigned int threads;
+		double milliseconds;
+		// Time of the single thread run divided by this one
+		double speedup;
+	};
+private:
+	unsigned int m_Rings;
+	unsigned int m_Sectors;
+	// rings + 1 points, empty for surfaces given by a VertexFunction
+	std::vector<ProfilePoint> m_Profile;
+	// sectors + 1 (cos, sin) pairs
+	std::vector<glm::vec2> m_SectorRotations;
+	// First index of every ring's triangles, rings + 1 entries
+	std::vector<size_t> m_RingIndexOffsets;
+	VertexFunction m_Function;
+
+	ParametricSurface(unsigned int rings, unsigned int sectors);
+	void Finish();
+	bool IsCollapsed(unsigned int ring) const;
+
+	// Rotates (cos, sin) by a fixed step instead of calling the trig functions for every element
+	static void FillRotations(glm::vec2* out, size_t count, double startAngle, double step);
+	static MeshData AllocateLods(const std::vector<ParametricSurface>& levels);
+	// Number of ring ranges the async generation splits the surface into for a pool
+	unsigned int GetRangeCount(unsigned int threadCount) const;
+	// Fills part range of the vertex rows and triangle bands split into rangeCount equal parts
+	void FillRange(Vertex* vertices, GLuint* indices, unsigned int range, unsigned int rangeCount) const;
+	// Sets every level's geometric error once its vertices are filled
+	static void MeasureLods(const std::vector<ParametricSurface>& levels, MeshData& data);
+public:
+	static ParametricSurface Sphere(float radius, unsigned int rings, unsigned int sectors);
+	static ParametricSurface Torus(float majorRadius, float minorRadius, unsigned int rings, unsigned int sectors);
+	// Open, without caps
+	static ParametricSurface Cylinder(float radius, float height, unsigned int rings, unsigned int sectors);
+	// Apex on top, open base
+	static ParametricSurface Cone(float radius, float height, unsigned int rings, unsigned int sectors);
+	// One-sheeted, x^2/a^2 + y^2/a^2 - z^2/c^2 = 1
+	static ParametricSurface Hyperboloid(float a, float c, float height, unsigned int rings, unsigned int sectors);
+	static ParametricSurface FromFunction(unsigned int rings, unsigned int sectors, VertexFunction function);
+	// Unit-sized shapes for the scene
+	static ParametricSurface Create(Type type, unsigned int rings, unsigned int sectors);
+	// Halves rings and sectors per level down to the minimum tessellation, finest first
+	static std::vector<ParametricSurface> CreateLodChain(Type type, unsigned int rings, unsigned int sectors, unsigned int maxLevels = 4);
+
+	inline size_t GetVertexCount() const { return (size_t)(m_Rings + 1) * (m_Sectors + 1); }
+	inline size_t GetIndexCount() const { return m_RingIndexOffsets.back(); }
+
+	MeshData Generate() const;
+	// Splits the rings into ranges filled on the pool's workers. The worker finishing the last range
+	// completes the job, so the caller never waits on the generation. Ranges are skipped once it's cancelled
+	void GenerateAsync(ThreadPool& pool, std::shared_ptr<MeshBuildJob> job) const;
+	// Same for a chain of levels stored in one MeshData, with the geometric error of every level
+	static MeshData GenerateLods(const std::vector<ParametricSurface>& levels);
+	static void GenerateLodsAsync(ThreadPool& pool, std::vector<ParametricSurface> levels, std::shared_ptr<MeshBuildJob> job);
+
+	// Generates one level on the calling thread, e.g. the 4096 x 4096 sphere of the Stats window.
+	// The time covers allocation and filling, not the optimisation and packing of a mesh build
+	static GenerateBenchmark MeasureGenerate(Type type, unsigned int rings, unsigned int sectors);
+	// Fills the same surface on pools of 1 to maxThreads workers, split into ranges like GenerateAsync.
+	// Only the parallel fill is timed, into buffers allocated once up front
+	static std::vector<ScalingBenchmark> MeasureScaling(Type type, unsigned int rings, unsigned int sectors, unsigned int maxThreads);
+
+	// Largest distance between the grid's triangles and the smooth surface, estimated from the filled vertices
+	float EstimateGeometricError(const Vertex* vertices) const;
+
+	// Both write into preallocated arrays, so ring ranges can be filled independently
+	void FillVertices(Vertex* vertices, unsigned int ringBegin, unsigned int ringEnd) const;
+	void FillIndices(GLuint* indices, unsigned int ringBegin, unsigned int ringEnd) const;
+};
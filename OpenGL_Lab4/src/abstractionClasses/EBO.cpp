@@ -1,26 +1,102 @@
 #include"EBO.h"
+#include"GLStateCache.h"
+#include <algorithm>
 
-EBO::EBO(std::vector<GLuint>& indices)
+GLenum EBO::ChooseIndexType(const std::vector<GLuint>& indices, bool primitiveRestart)
 {
-	glGenBuffers(1, &m_ID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	GLuint maxIndex = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+	GLuint reserved = primitiveRestart ? 1 : 0;
+	if (maxIndex <= 0xFF - reserved)
+		return GL_UNSIGNED_BYTE;
+	if (maxIndex <= 0xFFFF - reserved)
+		return GL_UNSIGNED_SHORT;
+	return GL_UNSIGNED_INT;
+}
+
+const void* EBO::Convert(const std::vector<GLuint>& indices, std::vector<unsigned char>& storage, size_t& size)
+{
+	// Primitive restart is never enabled, so 255 and 65535 are ordinary indices
+	m_IndexType = ChooseIndexType(indices);
+	if (m_IndexType == GL_UNSIGNED_INT)
+	{
+		size = indices.size() * sizeof(GLuint);
+		return indices.data();
+	}
+
+	if (m_IndexType == GL_UNSIGNED_BYTE)
+	{
+		storage.assign(indices.begin(), indices.end());
+	}
+	else
+	{
+		storage.resize(indices.size() * sizeof(GLushort));
+		GLushort* out = reinterpret_cast<GLushort*>(storage.data());
+		for (GLuint index : indices)
+			*out++ = (GLushort)index;
+	}
+	size = storage.size();
+	return storage.data();
+}
+
+EBO::EBO(const std::vector<GLuint>& indices)
+{
+	m_ID = UniqueBuffer::Create();
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID.Get());
+
+	std::vector<unsigned char> narrowed;
+	const void* data = Convert(indices, narrowed, m_Size);
+	m_Capacity = m_Size;
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Size, data, GL_STATIC_DRAW);
+}
+
+EBO::EBO(size_t indexCapacity)
+{
+	m_ID = UniqueBuffer::Create();
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID.Get());
+	m_Capacity = m_Size = indexCapacity * sizeof(GLuint);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Capacity, nullptr, GL_STATIC_DRAW);
+}
+
+void EBO::Update(const std::vector<GLuint>& indices)
+{
+	std::vector<unsigned char> narrowed;
+	size_t size;
+	const void* data = Convert(indices, narrowed, size);
+
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID.Get());
+	if (size > m_Capacity)
+	{
+		m_Capacity = std::max(size, m_Capacity * 2);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Capacity, nullptr, GL_DYNAMIC_DRAW);
+	}
+	else if (size != m_Size)
+	{
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Capacity, nullptr, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, data);
+	m_Size = size;
+}
+
+void EBO::Write(size_t firstIndex, const GLuint* indices, size_t count)
+{
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID.Get());
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, firstIndex * sizeof(GLuint), count * sizeof(GLuint), indices);
 }
 
 // Binds the EBO
 void EBO::Bind()
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID);
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID.Get());
 }
 
 // Unbinds the EBO
 void EBO::Unbind()
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 // Deletes the EBO
 void EBO::Delete()
 {
-	glDeleteBuffers(1, &m_ID);
+	m_ID.Reset();
 }
\ No newline at end of file
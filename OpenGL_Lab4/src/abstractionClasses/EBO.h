@@ -2,12 +2,37 @@
 #include <GL/glew.h>
 #include<vector>
 
+#include "GLHandles.h"
+
 class EBO
 {
 private:
-	GLuint m_ID;
+	UniqueBuffer m_ID;
+	size_t m_Capacity = 0;
+	size_t m_Size = 0;
+	GLenum m_IndexType = GL_UNSIGNED_INT;
+
+	// Picks the index type and returns the data to upload, narrowed into storage if a smaller type fits
+	const void* Convert(const std::vector<GLuint>& indices, std::vector<unsigned char>& storage, size_t& size);
 public:
-	EBO(std::vector<GLuint>& indices);
+	// Smallest type holding every index. With primitiveRestart (GL_PRIMITIVE_RESTART_FIXED_INDEX) the largest
+	// value of each type is the restart marker, so an index equal to it needs the next bigger type
+	static GLenum ChooseIndexType(const std::vector<GLuint>& indices, bool primitiveRestart = false);
+
+	EBO() = default;
+	EBO(const std::vector<GLuint>& indices);
+	// Uninitialized GL_UNSIGNED_INT storage filled range by range with Write. The owning VAO has to be bound
+	explicit EBO(size_t indexCapacity);
+
+	// Same reuse rules as VBO::Update. The owning VAO has to be bound
+	void Update(const std::vector<GLuint>& indices);
+	// Writes indices starting at firstIndex without resizing, only for GL_UNSIGNED_INT storage
+	void Write(size_t firstIndex, const GLuint* indices, size_t count);
+	inline size_t GetCapacity() const { return m_Capacity; }
+	inline size_t GetSize() const { return m_Size; }
+	// GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, pass it to the draw call
+	inline GLenum GetIndexType() const { return m_IndexType; }
+	inline size_t GetIndexSize() const { return m_IndexType == GL_UNSIGNED_BYTE ? 1 : m_IndexType == GL_UNSIGNED_SHORT ? 2 : 4; }
 	void Bind();
 	void Unbind();
 	void Delete();
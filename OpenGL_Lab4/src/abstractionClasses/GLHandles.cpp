@@ -0,0 +1,111 @@
+#include "GLHandles.h"
+#include "GLStateCache.h"
+
+#include <iostream>
+
+int GLResourceRegistry::s_LiveCounts[(int)GLResourceKind::Count] = {};
+
+#ifdef _DEBUG
+std::unordered_set<GLuint> GLResourceRegistry::s_LiveIds[(int)GLResourceKind::Count];
+#endif
+
+void GLResourceRegistry::OnCreated(GLResourceKind kind, GLuint id)
+{
+	s_LiveCounts[(int)kind]++;
+#ifdef _DEBUG
+	if (!s_LiveIds[(int)kind].insert(id).second)
+		std::cout << "GL " << GetKindName(kind) << " " << id << " IS OWNED TWICE!" << std::endl;
+#else
+	(void)id;
+#endif
+}
+
+void GLResourceRegistry::OnDeleted(GLResourceKind kind, GLuint id)
+{
+	s_LiveCounts[(int)kind]--;
+#ifdef _DEBUG
+	s_LiveIds[(int)kind].erase(id);
+#else
+	(void)id;
+#endif
+}
+
+int GLResourceRegistry::GetLiveCount(GLResourceKind kind) { return s_LiveCounts[(int)kind]; }
+
+const char* GLResourceRegistry::GetKindName(GLResourceKind kind)
+{
+	switch (kind)
+	{
+	case GLResourceKind::Buffer: return "buffer";
+	case GLResourceKind::VertexArray: return "vertex array";
+	case GLResourceKind::Texture: return "texture";
+	case GLResourceKind::Program: return "program";
+	default: return "unknown";
+	}
+}
+
+int GLResourceRegistry::ReportLeaks()
+{
+	int leaked = 0;
+	for (int kind = 0; kind < (int)GLResourceKind::Count; kind++)
+	{
+		if (s_LiveCounts[kind] == 0)
+			continue;
+		leaked += s_LiveCounts[kind];
+		std::cout << "LEAKED " << s_LiveCounts[kind] << " GL " << GetKindName((GLResourceKind)kind) << "(s)";
+#ifdef _DEBUG
+		std::cout << ":";
+		for (GLuint id : s_LiveIds[kind])
+			std::cout << " " << id;
+#endif
+		std::cout << std::endl;
+	}
+	return leaked;
+}
+
+GLuint BufferTraits::Create()
+{
+	GLuint id = 0;
+	glGenBuffers(1, &id);
+	return id;
+}
+
+void BufferTraits::Delete(GLuint id)
+{
+	glDeleteBuffers(1, &id);
+	GLStateCache::OnBufferDeleted(id);
+}
+
+GLuint VertexArrayTraits::Create()
+{
+	GLuint id = 0;
+	glGenVertexArrays(1, &id);
+	return id;
+}
+
+void VertexArrayTraits::Delete(GLuint id)
+{
+	glDeleteVertexArrays(1, &id);
+	GLStateCache::OnVertexArrayDeleted(id);
+}
+
+GLuint TextureTraits::Create()
+{
+	GLuint id = 0;
+	glGenTextures(1, &id);
+	return id;
+}
+
+void TextureTraits::Delete(GLuint id)
+{
+	glDeleteTextures(1, &id);
+	GLStateCache::OnTextureDeleted(id);
+}
+
+GLuint ProgramTraits::Create() { return glCreateProgram(); }
+
+void ProgramTraits::Delete(GLuint id)
+{
+	glDeleteProgram(id);
+	GLStateCache::OnProgramDeleted(id);
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <GL/glew.h>
+#include <utility>
+#ifdef _DEBUG
+#include <unordered_set>
+#endif
+
+enum class GLResourceKind { Buffer, VertexArray, Texture, Program, Count };
+
+/// <summary>
+/// Counts the GL objects owned by Unique* handles. Debug builds also remember their names,
+/// so ReportLeaks can list every object that is still alive when the scene is torn down
+/// </summary>
+class GLResourceRegistry
+{
+private:
+	static int s_LiveCounts[(int)GLResourceKind::Count];
+#ifdef _DEBUG
+	static std::unordered_set<GLuint> s_LiveIds[(int)GLResourceKind::Count];
+#endif
+public:
+	static void OnCreated(GLResourceKind kind, GLuint id);
+	static void OnDeleted(GLResourceKind kind, GLuint id);
+
+	static int GetLiveCount(GLResourceKind kind);
+	static const char* GetKindName(GLResourceKind kind);
+	// Returns the number of leaked objects. Call it after every owner is destroyed, but before the context is
+	static int ReportLeaks();
+};
+
+/// <summary>
+/// Move-only owner of a GL object name. The object is deleted with the handle,
+/// so a class holding handles releases its GPU resources without a hand-written destructor
+/// </summary>
+template<typename Traits>
+class UniqueHandle
+{
+private:
+	GLuint m_ID = 0;
+public:
+	UniqueHandle() = default;
+	// Takes ownership of an existing object
+	explicit UniqueHandle(GLuint id) : m_ID(id)
+	{
+		if (m_ID)
+			GLResourceRegistry::OnCreated(Traits::KIND, m_ID);
+	}
+	static UniqueHandle Create() { return UniqueHandle(Traits::Create()); }
+	~UniqueHandle() { Reset(); }
+
+	UniqueHandle(const UniqueHandle&) = delete;
+	UniqueHandle& operator=(const UniqueHandle&) = delete;
+
+	UniqueHandle(UniqueHandle&& other) noexcept : m_ID(std::exchange(other.m_ID, 0)) {}
+	UniqueHandle& operator=(UniqueHandle&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			m_ID = std::exchange(other.m_ID, 0);
+		}
+		return *this;
+	}
+
+	inline GLuint Get() const { return m_ID; }
+	inline explicit operator bool() const { return m_ID != 0; }
+
+	void Reset()
+	{
+		if (!m_ID)
+			return;
+		Traits::Delete(m_ID);
+		GLResourceRegistry::OnDeleted(Traits::KIND, m_ID);
+		m_ID = 0;
+	}
+};
+
+struct BufferTraits
+{
+	static const GLResourceKind KIND = GLResourceKind::Buffer;
+	static GLuint Create();
+	static void Delete(GLuint id);
+};
+
+struct VertexArrayTraits
+{
+	static const GLResourceKind KIND = GLResourceKind::VertexArray;
+	static GLuint Create();
+	static void Delete(GLuint id);
+};
+
+struct TextureTraits
+{
+	static const GLResourceKind KIND = GLResourceKind::Texture;
+	static GLuint Create();
+	static void Delete(GLuint id);
+};
+
+struct ProgramTraits
+{
+	static const GLResourceKind KIND = GLResourceKind::Program;
+	static GLuint Create();
+	static void Delete(GLuint id);
+};
+
+using UniqueBuffer = UniqueHandle<BufferTraits>;
+using UniqueVertexArray = UniqueHandle<VertexArrayTraits>;
+using UniqueTexture = UniqueHandle<TextureTraits>;
+using UniqueProgram = UniqueHandle<ProgramTraits>;
@@ -0,0 +1,241 @@
+#include "GLStateCache.h"
+#include <initializer_list>
+
+GLStateFunctions GLStateCache::s_Functions = GLStateCache::GetDefaultFunctions();
+
+GLuint GLStateCache::s_Program = UNKNOWN;
+GLuint GLStateCache::s_VertexArray = UNKNOWN;
+GLuint GLStateCache::s_ArrayBuffer = UNKNOWN;
+GLuint GLStateCache::s_ElementBuffer = UNKNOWN;
+GLuint GLStateCache::s_UniformBuffer = UNKNOWN;
+GLuint GLStateCache::s_ShaderStorageBuffer = UNKNOWN;
+GLuint GLStateCache::s_DrawIndirectBuffer = UNKNOWN;
+GLuint GLStateCache::s_ActiveTextureUnit = UNKNOWN;
+GLStateCache::BoundTexture GLStateCache::s_Textures[MAX_TEXTURE_UNITS];
+GLenum GLStateCache::s_PolygonMode = UNKNOWN;
+int GLStateCache::s_Blend = -1;
+int GLStateCache::s_DepthTest = -1;
+GLenum GLStateCache::s_BlendSourceFactor = UNKNOWN;
+GLenum GLStateCache::s_BlendDestinationFactor = UNKNOWN;
+GLenum GLStateCache::s_DepthFunc = UNKNOWN;
+
+unsigned int GLStateCache::s_IssuedCalls = 0;
+unsigned int GLStateCache::s_ElidedCalls = 0;
+
+const GLStateFunctions& GLStateCache::GetDefaultFunctions()
+{
+	// GLEW entry points are only resolved after glewInit, so they are called through lambdas
+	static const GLStateFunctions functions =
+	{
+		[](GLuint program) { glUseProgram(program); },
+		[](GLuint vertexArray) { glBindVertexArray(vertexArray); },
+		[](GLenum target, GLuint buffer) { glBindBuffer(target, buffer); },
+		[](GLenum target, GLuint index, GLuint buffer) { glBindBufferBase(target, index, buffer); },
+		[](GLenum unit) { glActiveTexture(unit); },
+		[](GLenum target, GLuint texture) { glBindTexture(target, texture); },
+		[](GLenum face, GLenum mode) { glPolygonMode(face, mode); },
+		[](GLenum capability) { glEnable(capability); },
+		[](GLenum capability) { glDisable(capability); },
+		[](GLenum sourceFactor, GLenum destinationFactor) { glBlendFunc(sourceFactor, destinationFactor); },
+		[](GLenum function) { glDepthFunc(function); }
+	};
+	return functions;
+}
+
+void GLStateCache::SetFunctions(const GLStateFunctions& functions)
+{
+	s_Functions = functions;
+	Invalidate();
+}
+
+void GLStateCache::Invalidate()
+{
+	s_Program = UNKNOWN;
+	s_VertexArray = UNKNOWN;
+	s_ArrayBuffer = UNKNOWN;
+	s_ElementBuffer = UNKNOWN;
+	s_UniformBuffer = UNKNOWN;
+	s_ShaderStorageBuffer = UNKNOWN;
+	s_DrawIndirectBuffer = UNKNOWN;
+	s_ActiveTextureUnit = UNKNOWN;
+	for (auto& texture : s_Textures)
+		texture = { UNKNOWN, UNKNOWN };
+	s_PolygonMode = UNKNOWN;
+	s_Blend = -1;
+	s_DepthTest = -1;
+	s_BlendSourceFactor = UNKNOWN;
+	s_BlendDestinationFactor = UNKNOWN;
+	s_DepthFunc = UNKNOWN;
+}
+
+// Updates the cached value and counts the call as issued or elided
+bool GLStateCache::Changes(GLuint& cached, GLuint value)
+{
+	if (cached == value)
+	{
+		s_ElidedCalls++;
+		return false;
+	}
+	cached = value;
+	s_IssuedCalls++;
+	return true;
+}
+
+void GLStateCache::UseProgram(GLuint program)
+{
+	if (Changes(s_Program, program))
+		s_Functions.UseProgram(program);
+}
+
+void GLStateCache::BindVertexArray(GLuint vertexArray)
+{
+	if (Changes(s_VertexArray, vertexArray))
+	{
+		s_Functions.BindVertexArray(vertexArray);
+		// The element buffer binding is part of the vertex array state
+		s_ElementBuffer = UNKNOWN;
+	}
+}
+
+GLuint* GLStateCache::GetBufferSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER: return &s_ArrayBuffer;
+	case GL_ELEMENT_ARRAY_BUFFER: return &s_ElementBuffer;
+	case GL_UNIFORM_BUFFER: return &s_UniformBuffer;
+	case GL_SHADER_STORAGE_BUFFER: return &s_ShaderStorageBuffer;
+	case GL_DRAW_INDIRECT_BUFFER: return &s_DrawIndirectBuffer;
+	default: return nullptr;
+	}
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+	GLuint* cached = GetBufferSlot(target);
+	if (!cached)
+	{
+		s_IssuedCalls++;
+		s_Functions.BindBuffer(target, buffer);
+	}
+	else if (Changes(*cached, buffer))
+		s_Functions.BindBuffer(target, buffer);
+}
+
+void GLStateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	s_IssuedCalls++;
+	s_Functions.BindBufferBase(target, index, buffer);
+	if (GLuint* cached = GetBufferSlot(target))
+		*cached = buffer;
+}
+
+void GLStateCache::ActiveTexture(GLuint unit)
+{
+	if (Changes(s_ActiveTextureUnit, unit))
+		s_Functions.ActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+	if (s_ActiveTextureUnit >= MAX_TEXTURE_UNITS)
+	{
+		s_IssuedCalls++;
+		s_Functions.BindTexture(target, texture);
+		return;
+	}
+
+	BoundTexture& bound = s_Textures[s_ActiveTextureUnit];
+	if (bound.target == target && bound.texture == texture)
+	{
+		s_ElidedCalls++;
+		return;
+	}
+	bound = { target, texture };
+	s_IssuedCalls++;
+	s_Functions.BindTexture(target, texture);
+}
+
+void GLStateCache::PolygonMode(GLenum mode)
+{
+	if (Changes(s_PolygonMode, mode))
+		s_Functions.PolygonMode(GL_FRONT_AND_BACK, mode);
+}
+
+void GLStateCache::SetCapability(int& cached, GLenum capability, bool enabled)
+{
+	if (cached == (int)enabled)
+	{
+		s_ElidedCalls++;
+		return;
+	}
+	cached = enabled;
+	s_IssuedCalls++;
+	if (enabled)
+		s_Functions.Enable(capability);
+	else
+		s_Functions.Disable(capability);
+}
+
+void GLStateCache::SetBlend(bool enabled) { SetCapability(s_Blend, GL_BLEND, enabled); }
+
+void GLStateCache::SetDepthTest(bool enabled) { SetCapability(s_DepthTest, GL_DEPTH_TEST, enabled); }
+
+void GLStateCache::BlendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+	if (s_BlendSourceFactor == sourceFactor && s_BlendDestinationFactor == destinationFactor)
+	{
+		s_ElidedCalls++;
+		return;
+	}
+	s_BlendSourceFactor = sourceFactor;
+	s_BlendDestinationFactor = destinationFactor;
+	s_IssuedCalls++;
+	s_Functions.BlendFunc(sourceFactor, destinationFactor);
+}
+
+void GLStateCache::DepthFunc(GLenum function)
+{
+	if (Changes(s_DepthFunc, function))
+		s_Functions.DepthFunc(function);
+}
+
+void GLStateCache::OnProgramDeleted(GLuint program)
+{
+	if (s_Program == program)
+		s_Program = UNKNOWN;
+}
+
+void GLStateCache::OnVertexArrayDeleted(GLuint vertexArray)
+{
+	if (s_VertexArray == vertexArray)
+		s_VertexArray = UNKNOWN;
+}
+
+void GLStateCache::OnBufferDeleted(GLuint buffer)
+{
+	for (GLuint* cached : { &s_ArrayBuffer, &s_ElementBuffer, &s_UniformBuffer, &s_ShaderStorageBuffer, &s_DrawIndirectBuffer })
+	{
+		if (*cached == buffer)
+			*cached = UNKNOWN;
+	}
+}
+
+void GLStateCache::OnTextureDeleted(GLuint texture)
+{
+	for (auto& bound : s_Textures)
+	{
+		if (bound.texture == texture)
+			bound = { UNKNOWN, UNKNOWN };
+	}
+}
+
+unsigned int GLStateCache::GetIssuedCalls() { return s_IssuedCalls; }
+
+unsigned int GLStateCache::GetElidedCalls() { return s_ElidedCalls; }
+
+void GLStateCache::ResetFrameCounters()
+{
+	s_IssuedCalls = 0;
+	s_ElidedCalls = 0;
+}
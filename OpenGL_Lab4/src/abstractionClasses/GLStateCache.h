@@ -0,0 +1,93 @@
+#pragma once
+#include <GL/glew.h>
+
+// GL entry points used by GLStateCache. Can be replaced with SetFunctions, e.g. by a mock table
+struct GLStateFunctions
+{
+	void (*UseProgram)(GLuint program);
+	void (*BindVertexArray)(GLuint vertexArray);
+	void (*BindBuffer)(GLenum target, GLuint buffer);
+	void (*BindBufferBase)(GLenum target, GLuint index, GLuint buffer);
+	void (*ActiveTexture)(GLenum unit);
+	void (*BindTexture)(GLenum target, GLuint texture);
+	void (*PolygonMode)(GLenum face, GLenum mode);
+	void (*Enable)(GLenum capability);
+	void (*Disable)(GLenum capability);
+	void (*BlendFunc)(GLenum sourceFactor, GLenum destinationFactor);
+	void (*DepthFunc)(GLenum function);
+};
+
+/// <summary>
+/// Remembers the currently bound GL objects and render state and skips calls that would not change anything.
+/// All binds of the abstraction classes go through here, so the cache only has to be invalidated
+/// when state is changed behind its back
+/// </summary>
+class GLStateCache
+{
+public:
+	static const int MAX_TEXTURE_UNITS = 16;
+private:
+	// Value that never matches a real binding, so the first call after Invalidate is always issued
+	static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+	// Starts unknown like every other slot, so binding texture 0 before the first Invalidate isn't elided
+	struct BoundTexture
+	{
+		GLenum target = UNKNOWN;
+		GLuint texture = UNKNOWN;
+	};
+
+	static GLStateFunctions s_Functions;
+
+	static GLuint s_Program;
+	static GLuint s_VertexArray;
+	static GLuint s_ArrayBuffer;
+	static GLuint s_ElementBuffer;
+	static GLuint s_UniformBuffer;
+	static GLuint s_ShaderStorageBuffer;
+	static GLuint s_DrawIndirectBuffer;
+	static GLuint s_ActiveTextureUnit;
+	static BoundTexture s_Textures[MAX_TEXTURE_UNITS];
+	static GLenum s_PolygonMode;
+	static int s_Blend;
+	static int s_DepthTest;
+	static GLenum s_BlendSourceFactor;
+	static GLenum s_BlendDestinationFactor;
+	static GLenum s_DepthFunc;
+
+	static unsigned int s_IssuedCalls;
+	static unsigned int s_ElidedCalls;
+
+	static bool Changes(GLuint& cached, GLuint value);
+	static GLuint* GetBufferSlot(GLenum target);
+	static void SetCapability(int& cached, GLenum capability, bool enabled);
+public:
+	static const GLStateFunctions& GetDefaultFunctions();
+	static void SetFunctions(const GLStateFunctions& functions);
+	// Forgets all cached state, the next call of every kind is issued
+	static void Invalidate();
+
+	static void UseProgram(GLuint program);
+	static void BindVertexArray(GLuint vertexArray);
+	static void BindBuffer(GLenum target, GLuint buffer);
+	// Indexed binding, also changes the generic binding of the target
+	static void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+	static void ActiveTexture(GLuint unit);
+	// Binds to the active texture unit
+	static void BindTexture(GLenum target, GLuint texture);
+	static void PolygonMode(GLenum mode);
+	static void SetBlend(bool enabled);
+	static void BlendFunc(GLenum sourceFactor, GLenum destinationFactor);
+	static void SetDepthTest(bool enabled);
+	static void DepthFunc(GLenum function);
+
+	// Deleted objects are unbound by GL, so they are dropped from the cache too
+	static void OnProgramDeleted(GLuint program);
+	static void OnVertexArrayDeleted(GLuint vertexArray);
+	static void OnBufferDeleted(GLuint buffer);
+	static void OnTextureDeleted(GLuint texture);
+
+	static unsigned int GetIssuedCalls();
+	static unsigned int GetElidedCalls();
+	static void ResetFrameCounters();
+};
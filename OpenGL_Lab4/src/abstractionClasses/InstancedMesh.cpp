@@ -0,0 +1,52 @@
+#include "InstancedMesh.h"
+
+#include <cstddef>
+
+InstancedMesh::InstancedMesh(MeshData data, const MeshSettings& settings)
+	: Mesh(std::move(data), nullptr, settings), m_InstanceVBO(nullptr, 0)
+{
+	GetVAO().Bind();
+	// A mat4 attribute takes one location per column
+	for (GLuint column = 0; column < 4; column++)
+		GetVAO().LinkInstanceAttrib(m_InstanceVBO, INSTANCE_MODEL_LOCATION + column, 4, GL_FLOAT, sizeof(Instance), (void*)(column * sizeof(glm::vec4)));
+	GetVAO().LinkInstanceAttrib(m_InstanceVBO, INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, sizeof(Instance), (void*)offsetof(Instance, color));
+	GetVAO().Unbind();
+}
+
+size_t InstancedMesh::Add(const glm::mat4& model, glm::vec4 color)
+{
+	if (m_InstanceCount == m_Instances.size())
+		m_Instances.push_back({ model, color });
+	Set(m_InstanceCount, model, color);
+	return m_InstanceCount++;
+}
+
+void InstancedMesh::Set(size_t instance, const glm::mat4& model, glm::vec4 color)
+{
+	Instance& slot = m_Instances[instance];
+	if (slot.model != model || slot.color != color)
+	{
+		slot = { model, color };
+		m_InstancesChanged = true;
+	}
+}
+
+void InstancedMesh::Clear()
+{
+	m_InstanceCount = 0;
+}
+
+void InstancedMesh::Render(Shader& shader)
+{
+	if (m_InstanceCount == 0)
+		return;
+
+	// Fewer instances than last time are still in the VBO, more need an upload
+	if (m_InstancesChanged || m_InstanceCount > m_UploadedCount)
+	{
+		m_InstanceVBO.Update(m_Instances.data(), m_InstanceCount * sizeof(Instance));
+		m_UploadedCount = m_InstanceCount;
+		m_InstancesChanged = false;
+	}
+	Draw(shader, (GLsizei)m_InstanceCount);
+}
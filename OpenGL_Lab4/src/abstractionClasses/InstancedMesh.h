@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+
+#include "Mesh.h"
+
+/// <summary>
+/// Mesh drawn once per instance with a single glDrawElementsInstanced call.
+/// Per-instance model matrices and colors live in an instance VBO. Instances can be cleared and added again
+/// every frame, the VBO is only re-uploaded when their content changed.
+/// Shaders read them at INSTANCE_MODEL_LOCATION (a mat4, four locations) and INSTANCE_COLOR_LOCATION
+/// </summary>
+class InstancedMesh : public Mesh
+{
+public:
+	static const GLuint INSTANCE_MODEL_LOCATION = 3;
+	static const GLuint INSTANCE_COLOR_LOCATION = 7;
+
+	struct Instance
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+	};
+private:
+	VBO m_InstanceVBO;
+	// Slots stay allocated after Clear, Add compares against what was there
+	std::vector<Instance> m_Instances;
+	size_t m_InstanceCount = 0;
+	size_t m_UploadedCount = 0;
+	bool m_InstancesChanged = false;
+public:
+	InstancedMesh(MeshData data, const MeshSettings& settings = MeshSettings());
+
+	// Returns the index of the new instance
+	size_t Add(const glm::mat4& model, glm::vec4 color = glm::vec4(1.f));
+	void Set(size_t instance, const glm::mat4& model, glm::vec4 color);
+	void Clear();
+	inline size_t GetInstanceCount() const { return m_InstanceCount; }
+
+	// Draws every instance, nothing if there are none
+	void Render(Shader& shader) override;
+};
@@ -1,46 +1,217 @@
 #include "Mesh.h"
 
-Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, Texture *texture)
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+bool MeshData::IsValid() const
 {
-	this->vertices = vertices;
-	this->indices = indices;
-	if(texture)
-		this->texture = texture;
+	if (lods.empty())
+		return std::all_of(indices.begin(), indices.end(), [this](GLuint index) { return index < vertices.size(); });
 
-	SetVAO();
+	for (const MeshLod& lod : lods)
+	{
+		if (lod.baseVertex < 0 || lod.indexCount < 0 || lod.vertexCount < 0 ||
+			lod.firstIndex + lod.indexCount > indices.size() || (size_t)lod.baseVertex + lod.vertexCount > vertices.size())
+			return false;
+		for (size_t i = lod.firstIndex; i < lod.firstIndex + lod.indexCount; i++)
+		{
+			if (indices[i] >= (GLuint)lod.vertexCount)
+				return false;
+		}
+	}
+	return true;
 }
 
-void Mesh::SetVAO()
+MeshStaging MeshStaging::Prepare(MeshData data, const MeshSettings& settings)
 {
+	// Out of range indices would read past the vertex arrays here and on the GPU
+	if (!data.IsValid())
+	{
+		assert(!"MeshData has indices outside its vertex range");
+		std::cout << "MESH ERROR: indices outside the vertex range, the mesh is left empty" << std::endl;
+		MeshStaging empty;
+		empty.data.lods.push_back(MeshLod());
+		return empty;
+	}
+
+	if (data.lods.empty())
+		data.lods.push_back({ 0, (GLsizei)data.indices.size(), 0, (GLsizei)data.vertices.size(), 0.f });
+
+	// Levels are drawn separately, so each one is optimised and reassembled on its own.
+	// Unused vertices are dropped, which moves the later levels
+	MeshStaging staging;
+	staging.data.vertices.reserve(data.vertices.size());
+	staging.data.indices.reserve(data.indices.size());
+	for (size_t i = 0; i < data.lods.size(); i++)
+	{
+		const MeshLod& source = data.lods[i];
+		std::vector<Vertex> vertices(data.vertices.begin() + source.baseVertex, data.vertices.begin() + source.baseVertex + source.vertexCount);
+		std::vector<GLuint> indices(data.indices.begin() + source.firstIndex, data.indices.begin() + source.firstIndex + source.indexCount);
+
+		VertexCacheStats before = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+		VertexCacheStats after = before;
+		if (settings.optimize)
+		{
+			MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+			MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+			after = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+		}
+		if (i == 0)
+		{
+			staging.cacheStatsBefore = before;
+			staging.cacheStatsAfter = after;
+		}
+
+		MeshLod lod = source;
+		lod.firstIndex = staging.data.indices.size();
+		lod.baseVertex = (GLint)staging.data.vertices.size();
+		lod.vertexCount = (GLsizei)vertices.size();
+		staging.data.lods.push_back(lod);
+		staging.data.vertices.insert(staging.data.vertices.end(), vertices.begin(), vertices.end());
+		staging.data.indices.insert(staging.data.indices.end(), indices.begin(), indices.end());
+	}
+
+	// Center of the bounding box, close enough to the minimal sphere for LOD selection
+	if (!staging.data.vertices.empty())
+	{
+		glm::vec3 min = staging.data.vertices[0].position, max = min;
+		for (const Vertex& vertex : staging.data.vertices)
+		{
+			min = glm::min(min, vertex.position);
+			max = glm::max(max, vertex.position);
+		}
+		staging.box = { min, max };
+		staging.bounds.center = (min + max) * 0.5f;
+		for (const Vertex& vertex : staging.data.vertices)
+			staging.bounds.radius = std::max(staging.bounds.radius, glm::distance(staging.bounds.center, vertex.position));
+	}
+
+	if (settings.format != VertexFormat::Float)
+		staging.packedVertices = VertexLayout(settings.format).Pack(staging.data.vertices, staging.dequantization);
+	return staging;
+}
+
+Mesh::Mesh(MeshData data, Texture* texture, const MeshSettings& settings)
+	: Mesh(MeshStaging::Prepare(std::move(data), settings), texture, settings)
+{
+}
+
+Mesh::Mesh(MeshStaging staging, Texture* texture, const MeshSettings& settings)
+	: m_Settings(settings), m_Layout(settings.format)
+{
+	this->texture = texture;
+
 	m_VAO.Bind();
-	VBO VBO(vertices);
-	EBO EBO(indices);
-	m_VAO.LinkAttrib(VBO, 0, 3, GL_FLOAT, sizeof(Vertex), (void*)0);
-	m_VAO.LinkAttrib(VBO, 1, 2, GL_FLOAT, sizeof(Vertex), (void*)(3 * sizeof(float)));
-	m_VAO.LinkAttrib(VBO, 2, 3, GL_FLOAT, sizeof(Vertex), (void*)(5 * sizeof(float)));
+	Upload(staging, true);
+	m_VAO.LinkAttribs(m_VBO, m_Layout);
 
 	m_VAO.Unbind();
-	VBO.Unbind();
-	EBO.Unbind();
+	m_VBO.Unbind();
+	m_EBO.Unbind();
 }
 
-void Mesh::Render(Shader& shader, Camera& camera)
+void Mesh::Update(MeshData data)
 {
-	shader.Bind();
+	Update(MeshStaging::Prepare(std::move(data), m_Settings));
+}
+
+void Mesh::Update(MeshStaging staging)
+{
+	// The element buffer binding belongs to the VAO
 	m_VAO.Bind();
+	Upload(staging, false);
+	m_VAO.Unbind();
+}
 
-	if (texture)
+// Float vertices are uploaded as they are, other formats were packed by MeshStaging::Prepare
+void Mesh::Upload(MeshStaging& staging, bool create)
+{
+	const void* vertices = staging.data.vertices.data();
+	size_t size = staging.data.vertices.size() * sizeof(Vertex);
+	if (m_Layout.GetFormat() != VertexFormat::Float)
 	{
-		shader.SetUniform1f("hasTexture", 1.f);
-		texture->texUnit(shader, "tex0", 0);
-		texture->Bind();
+		vertices = staging.packedVertices.data();
+		size = staging.packedVertices.size();
 	}
-	else if (glGetUniformLocation(shader.ID, "hasTexture") != -1)
+
+	if (create)
 	{
-		shader.SetUniform1f("hasTexture", 0.f);
+		m_VBO = VBO(vertices, size);
+		m_EBO = EBO(staging.data.indices);
 	}
+	else
+	{
+		m_VBO.Update(vertices, size);
+		m_EBO.Update(staging.data.indices);
+	}
+
+	m_Lods = staging.data.lods;
+	m_CurrentLod = std::min(m_CurrentLod, m_Lods.size() - 1);
+	m_Bounds = staging.bounds;
+	m_Box = staging.box;
+	m_Dequantization = staging.dequantization;
+	m_CacheStatsBefore = staging.cacheStatsBefore;
+	m_CacheStatsAfter = staging.cacheStatsAfter;
+	m_Data = m_Settings.retainCpuData ? std::move(staging.data) : MeshData();
+}
+
+void Mesh::SetLod(size_t lod)
+{
+	m_CurrentLod = std::min(lod, m_Lods.size() - 1);
+}
+
+const MeshData* Mesh::GetCpuData() const
+{
+	return m_Settings.retainCpuData ? &m_Data : nullptr;
+}
+
+void Mesh::Render(Shader& shader)
+{
+	Draw(shader, 1);
+}
+
+// A mesh is drawn with a handful of programs (e.g. the lit variants), so a linear search is enough
+Mesh::DrawUniforms Mesh::GetDrawUniforms(const Shader& shader)
+{
+	for (const DrawUniforms& uniforms : m_DrawUniforms)
+	{
+		if (uniforms.program == shader.ID.Get())
+			return uniforms;
+	}
+
+	DrawUniforms uniforms;
+	uniforms.program = shader.ID.Get();
+	uniforms.tex0 = shader.GetUniform("tex0");
+	uniforms.dequantization = shader.GetUniform("dequantization");
+	// An unlinked program has no uniform table yet, its handles are resolved again once it's linked
+	if (shader.IsLinked())
+		m_DrawUniforms.push_back(uniforms);
+	return uniforms;
+}
+
+void Mesh::Draw(Shader& shader, GLsizei instanceCount)
+{
+	shader.Bind();
+	m_VAO.Bind();
+	DrawUniforms uniforms = GetDrawUniforms(shader);
 
-	camera.UpdateMatrix(shader, "camMatrix");
-	
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-}
\ No newline at end of file
+	// Textured meshes are drawn with a shader variant that samples tex0 (unless its fallback is bound)
+	if (texture && uniforms.tex0.IsValid())
+	{
+		texture->texUnit(shader, uniforms.tex0, 0);
+		texture->Bind();
+	}
+
+	if (uniforms.dequantization.IsValid())
+		shader.SetUniform(uniforms.dequantization, m_Dequantization);
+
+	// Camera matrices aren't set here, they're read from the shared CameraUniformBlock
+
+	const MeshLod& lod = m_Lods[m_CurrentLod];
+	void* firstIndex = (void*)(lod.firstIndex * m_EBO.GetIndexSize());
+	if (instanceCount == 1)
+		glDrawElementsBaseVertex(GL_TRIANGLES, lod.indexCount, m_EBO.GetIndexType(), firstIndex, lod.baseVertex);
+	else
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, lod.indexCount, m_EBO.GetIndexType(), firstIndex, instanceCount, lod.baseVertex);
+}
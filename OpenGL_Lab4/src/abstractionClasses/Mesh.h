@@ -4,24 +4,144 @@
 
 #include"VAO.h"
 #include"EBO.h"
-#include"Camera.h"
+#include"shader.h"
 #include"Texture.h"
+#include"meshOptimizer.h"
 
+// One level of detail inside the mesh's buffers. Its indices are relative to baseVertex
+struct MeshLod
+{
+	size_t firstIndex = 0;
+	GLsizei indexCount = 0;
+	GLint baseVertex = 0;
+	GLsizei vertexCount = 0;
+	// Largest distance between this level and the surface it approximates, in model units
+	float geometricError = 0.f;
+};
+
+struct BoundingSphere
+{
+	glm::vec3 center = glm::vec3(0.f);
+	float radius = 0.f;
+};
+
+struct AxisAlignedBox
+{
+	glm::vec3 min = glm::vec3(0.f);
+	glm::vec3 max = glm::vec3(0.f);
+};
+
+// Geometry of a mesh. It's moved into the Mesh, so building a mesh doesn't copy it
+struct MeshData
+{
+	std::vector<Vertex> vertices;
+	std::vector<GLuint> indices;
+	// Levels stored one after another, finest first. Empty means a single level covering all the data
+	std::vector<MeshLod> lods;
+
+	inline size_t GetByteSize() const { return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(GLuint); }
+	// Every level lies inside the arrays and its indices are below its vertexCount
+	bool IsValid() const;
+};
+
+struct MeshSettings
+{
+	// Keeps the geometry readable through GetCpuData (e.g. for picking or collision), otherwise it's freed after the upload
+	bool retainCpuData = false;
+	// Packed formats need a shader with the dequantization uniform, like lit.shader
+	VertexFormat format = VertexFormat::Float;
+	// Reorders triangles for the post-transform cache and vertices for fetch locality before every upload
+	bool optimize = false;
+};
+
+// Upload-ready geometry. Preparing it doesn't touch GL, so it can run on a worker thread
+struct MeshStaging
+{
+	MeshData data;
+	// Vertices in the settings' format, empty for VertexFormat::Float which is uploaded from data
+	std::vector<unsigned char> packedVertices;
+	glm::mat4 dequantization = glm::mat4(1.f);
+	// Of the finest level
+	VertexCacheStats cacheStatsBefore;
+	VertexCacheStats cacheStatsAfter;
+	BoundingSphere bounds;
+	AxisAlignedBox box;
+
+	// Optimises every level on its own and packs the geometry. Use the settings of the mesh it will be uploaded to.
+	// Invalid data (see MeshData::IsValid) is rejected, the result is a single empty level
+	static MeshStaging Prepare(MeshData data, const MeshSettings& settings);
+};
 
 class Mesh
 {
 private:
+	// The VAO keeps referencing both buffers, so they live as long as the mesh
 	VAO m_VAO;
+	VBO m_VBO;
+	EBO m_EBO;
+	MeshData m_Data;
+	std::vector<MeshLod> m_Lods;
+	size_t m_CurrentLod = 0;
+	BoundingSphere m_Bounds;
+	AxisAlignedBox m_Box;
+	MeshSettings m_Settings;
+	VertexLayout m_Layout;
+	VertexCacheStats m_CacheStatsBefore;
+	VertexCacheStats m_CacheStatsAfter;
+	// Restores quantized positions, set as the "dequantization" uniform
+	glm::mat4 m_Dequantization = glm::mat4(1.f);
+
+	// Uniforms Draw sets, resolved once per program the mesh is drawn with
+	struct DrawUniforms
+	{
+		GLuint program = 0;
+		UniformHandle tex0;
+		UniformHandle dequantization;
+	};
+	std::vector<DrawUniforms> m_DrawUniforms;
+
+	void Upload(MeshStaging& staging, bool create);
+	DrawUniforms GetDrawUniforms(const Shader& shader);
 protected:
-	void SetVAO();
+	// Instance attributes are added to the mesh's own VAO
+	inline VAO& GetVAO() { return m_VAO; }
+	// Sets the mesh's uniforms and draws the current level instanceCount times
+	void Draw(Shader& shader, GLsizei instanceCount);
 public:
-	std::vector<Vertex> vertices;
-	std::vector<GLuint> indices;
-	Texture* texture;
+	Texture* texture = nullptr;
 
-	Mesh(std::vector <Vertex>& vertices, std::vector <GLuint>& indices, Texture* texture = nullptr);
-	Mesh() {};
+	Mesh(MeshData data, Texture* texture = nullptr, const MeshSettings& settings = MeshSettings());
+	Mesh(MeshStaging staging, Texture* texture = nullptr, const MeshSettings& settings = MeshSettings());
+	virtual ~Mesh() = default;
 
-	void Render(Shader& shader, Camera& camera);
-};
+	// Uploads new geometry into the existing buffers instead of creating new ones
+	void Update(MeshData data);
+	void Update(MeshStaging staging);
+	virtual void Render(Shader& shader);
+
+	inline const MeshSettings& GetSettings() const { return m_Settings; }
+	inline GLuint GetVertexArrayID() const { return m_VAO.GetID(); }
+	// nullptr if the CPU copy was dropped
+	const MeshData* GetCpuData() const;
+	// Selects the level drawn by Render, clamped to the available ones
+	void SetLod(size_t lod);
+	inline size_t GetCurrentLod() const { return m_CurrentLod; }
+	inline size_t GetLodCount() const { return m_Lods.size(); }
+	inline const MeshLod& GetLod(size_t lod) const { return m_Lods[lod]; }
+	inline const BoundingSphere& GetBounds() const { return m_Bounds; }
+	// In model space, of all levels
+	inline const AxisAlignedBox& GetBox() const { return m_Box; }
+	// Of the current level
+	inline GLsizei GetIndexCount() const { return m_Lods[m_CurrentLod].indexCount; }
+	inline GLenum GetIndexType() const { return m_EBO.GetIndexType(); }
+	inline size_t GetIndexSize() const { return m_EBO.GetIndexSize(); }
+	inline const VertexLayout& GetLayout() const { return m_Layout; }
+	// Post-transform cache statistics of the last upload's finest level, before and after optimisation (equal if it's disabled)
+	inline VertexCacheStats GetCacheStatsBefore() const { return m_CacheStatsBefore; }
+	inline VertexCacheStats GetCacheStatsAfter() const { return m_CacheStatsAfter; }
 
+	// Memory report: bytes allocated on the GPU, bytes of the last upload and bytes still held in RAM
+	inline size_t GetGpuBytes() const { return m_VBO.GetCapacity() + m_EBO.GetCapacity(); }
+	inline size_t GetUploadedBytes() const { return m_VBO.GetSize() + m_EBO.GetSize(); }
+	inline size_t GetCpuBytes() const { return m_Data.GetByteSize(); }
+};
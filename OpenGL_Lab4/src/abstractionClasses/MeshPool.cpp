@@ -0,0 +1,63 @@
+#include "MeshPool.h"
+
+MeshPool::MeshPool(size_t vertexCapacity, size_t indexCapacity)
+	: m_Vertices(vertexCapacity), m_Indices(indexCapacity)
+{
+	m_VAO.Bind();
+	m_VBO = VBO(nullptr, vertexCapacity * sizeof(Vertex));
+	m_EBO = EBO(indexCapacity);
+	m_VAO.LinkAttribs(m_VBO, VertexLayout(VertexFormat::Float));
+	m_VAO.Unbind();
+}
+
+PooledMesh MeshPool::Allocate(MeshData data)
+{
+	MeshSettings settings;
+	settings.optimize = true;
+	if (data.lods.size() > 1)
+		data.lods.resize(1);
+	MeshStaging staging = MeshStaging::Prepare(std::move(data), settings);
+
+	PooledMesh mesh;
+	const MeshLod& lod = staging.data.lods[0];
+	// Prepare leaves data with indices outside its vertices empty, drawing it would read another mesh's vertices
+	if (lod.indexCount == 0)
+		return mesh;
+
+	size_t firstVertex = m_Vertices.Allocate(lod.vertexCount);
+	size_t firstIndex = m_Indices.Allocate(lod.indexCount);
+	if (firstVertex == RangeAllocator::INVALID || firstIndex == RangeAllocator::INVALID)
+	{
+		m_Vertices.Free(firstVertex, lod.vertexCount);
+		m_Indices.Free(firstIndex, lod.indexCount);
+		return mesh;
+	}
+
+	mesh.firstIndex = (GLuint)firstIndex;
+	mesh.indexCount = lod.indexCount;
+	mesh.baseVertex = (GLint)firstVertex;
+	mesh.vertexCount = lod.vertexCount;
+	mesh.bounds = staging.bounds;
+	mesh.box = staging.box;
+
+	m_VBO.Write(firstVertex * sizeof(Vertex), staging.data.vertices.data(), lod.vertexCount * sizeof(Vertex));
+	// The element buffer binding belongs to the VAO
+	m_VAO.Bind();
+	m_EBO.Write(firstIndex, staging.data.indices.data(), lod.indexCount);
+	m_VAO.Unbind();
+	return mesh;
+}
+
+void MeshPool::Free(PooledMesh& mesh)
+{
+	if (!mesh.IsValid())
+		return;
+	m_Vertices.Free(mesh.baseVertex, mesh.vertexCount);
+	m_Indices.Free(mesh.firstIndex, mesh.indexCount);
+	mesh = PooledMesh();
+}
+
+void MeshPool::Bind()
+{
+	m_VAO.Bind();
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Mesh.h"
+#include "rangeAllocator.h"
+
+// A mesh stored in a MeshPool's shared buffers
+struct PooledMesh
+{
+	GLuint firstIndex = 0;
+	GLuint indexCount = 0;
+	GLint baseVertex = 0;
+	GLuint vertexCount = 0;
+	BoundingSphere bounds;
+	AxisAlignedBox box;
+
+	inline bool IsValid() const { return indexCount != 0; }
+};
+
+/// <summary>
+/// Suballocates the vertices and indices of many small meshes from one VBO/EBO pair behind a single VAO,
+/// so they can be drawn without switching buffers (see RenderQueue). Vertices use VertexFormat::Float,
+/// indices are 32 bit and relative to the mesh's baseVertex
+/// </summary>
+class MeshPool
+{
+private:
+	VAO m_VAO;
+	VBO m_VBO;
+	EBO m_EBO;
+	RangeAllocator m_Vertices;
+	RangeAllocator m_Indices;
+public:
+	// Capacities are fixed, Allocate fails once they're used up
+	MeshPool(size_t vertexCapacity, size_t indexCapacity);
+
+	// Optimises the finest level of the data and copies it into the pool.
+	// Invalid if it doesn't fit or MeshStaging::Prepare rejected the data, e.g. for an index outside its vertices
+	PooledMesh Allocate(MeshData data);
+	void Free(PooledMesh& mesh);
+
+	void Bind();
+	inline GLuint GetVertexArrayID() const { return m_VAO.GetID(); }
+	inline size_t GetUsedVertices() const { return m_Vertices.GetUsed(); }
+	inline size_t GetUsedIndices() const { return m_Indices.GetUsed(); }
+	inline size_t GetVertexCapacity() const { return m_Vertices.GetCapacity(); }
+	inline size_t GetIndexCapacity() const { return m_Indices.GetCapacity(); }
+};
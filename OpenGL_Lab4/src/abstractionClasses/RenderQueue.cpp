@@ -0,0 +1,184 @@
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+RenderQueue::RenderQueue()
+{
+	if (IsMultiDrawSupported())
+	{
+		m_CommandBuffer = UniqueBuffer::Create();
+		m_DrawDataBuffer = UniqueBuffer::Create();
+	}
+}
+
+bool RenderQueue::IsMultiDrawSupported()
+{
+	return GLEW_VERSION_4_3 && GLEW_ARB_shader_draw_parameters;
+}
+
+std::vector<std::string> RenderQueue::GetShaderDefines()
+{
+	if (IsMultiDrawSupported())
+		return { "MULTI_DRAW" };
+	return {};
+}
+
+// GL names are small sequential integers, so their low bits tell objects apart
+uint64_t RenderQueue::MakeSortKey(RenderPass pass, GLuint program, GLuint texture, GLuint vertexArray, float depth)
+{
+	uint64_t quantizedDepth = (uint64_t)(std::min(std::max(depth / MAX_SORT_DEPTH, 0.f), 1.f) * 0xFFFFFF);
+	if (pass == RenderPass::Transparent)
+		quantizedDepth = 0xFFFFFF - quantizedDepth;
+
+	return ((uint64_t)pass & 0xF) << 60
+		| ((uint64_t)program & 0xFFF) << 48
+		| ((uint64_t)texture & 0xFFF) << 36
+		| ((uint64_t)vertexArray & 0xFFF) << 24
+		| quantizedDepth;
+}
+
+void RenderQueue::Submit(Mesh& mesh, Shader& shader, float depth, RenderPass pass)
+{
+	Item item = {};
+	item.shader = &shader;
+	item.mesh = &mesh;
+	item.program = shader.ID.Get();
+	item.texture = mesh.texture ? mesh.texture->ID.Get() : 0;
+	item.vertexArray = mesh.GetVertexArrayID();
+	m_Order.push_back({ MakeSortKey(pass, item.program, item.texture, item.vertexArray, depth), (uint32_t)m_Items.size() });
+	m_Items.push_back(item);
+}
+
+void RenderQueue::Submit(MeshPool& pool, const PooledMesh& mesh, Shader& shader, const glm::mat4& model, glm::vec4 color, float depth, RenderPass pass)
+{
+	if (!mesh.IsValid())
+		return;
+
+	Item item = {};
+	item.shader = &shader;
+	item.pool = &pool;
+	item.pooledMesh = mesh;
+	item.program = shader.ID.Get();
+	item.drawData = { model, color };
+	item.vertexArray = pool.GetVertexArrayID();
+	m_Order.push_back({ MakeSortKey(pass, item.program, 0, item.vertexArray, depth), (uint32_t)m_Items.size() });
+	m_Items.push_back(item);
+}
+
+void RenderQueue::CountStateChanges(const std::vector<SortEntry>& order, const std::vector<Item>& items, RenderQueueStats& stats)
+{
+	stats = RenderQueueStats();
+	stats.items = (unsigned int)order.size();
+	const Item* previous = nullptr;
+	for (const SortEntry& entry : order)
+	{
+		const Item& item = items[entry.index];
+		// Pooled runs are one multi-draw call
+		bool sameRun = previous && item.pool && IsMultiDrawSupported() && item.pool == previous->pool && item.program == previous->program;
+		if (!sameRun)
+			stats.drawCalls++;
+		if (!previous || item.program != previous->program)
+			stats.programChanges++;
+		if (!previous || item.texture != previous->texture)
+			stats.textureChanges++;
+		if (!previous || item.vertexArray != previous->vertexArray)
+			stats.vertexArrayChanges++;
+		previous = &item;
+	}
+}
+
+void RenderQueue::Upload(UniqueBuffer& buffer, GLenum target, size_t& capacity, const void* data, size_t size)
+{
+	GLStateCache::BindBuffer(target, buffer.Get());
+	if (size > capacity)
+		capacity = std::max(size, capacity * 2);
+	glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(target, 0, size, data);
+}
+
+void RenderQueue::Flush()
+{
+	CountStateChanges(m_Order, m_Items, m_LastUnsortedStats);
+	RadixSort::Sort(m_Order, m_SortScratch);
+	CountStateChanges(m_Order, m_Items, m_LastStats);
+
+	for (size_t i = 0; i < m_Order.size(); i++)
+	{
+		Item& item = m_Items[m_Order[i].index];
+		if (item.mesh)
+		{
+			item.mesh->Render(*item.shader);
+			continue;
+		}
+
+		m_Commands.push_back({ item.pooledMesh.indexCount, 1, item.pooledMesh.firstIndex, item.pooledMesh.baseVertex, 0 });
+		m_DrawData.push_back(item.drawData);
+		const Item* next = i + 1 < m_Order.size() ? &m_Items[m_Order[i + 1].index] : nullptr;
+		if (!next || next->pool != item.pool || next->program != item.program)
+			FlushPooled(*item.shader, *item.pool);
+	}
+
+	m_Items.clear();
+	m_Order.clear();
+}
+
+void RenderQueue::FlushPooled(Shader& shader, MeshPool& pool)
+{
+	shader.Bind();
+	pool.Bind();
+
+	if (IsMultiDrawSupported())
+	{
+		Upload(m_CommandBuffer, GL_DRAW_INDIRECT_BUFFER, m_CommandCapacity, m_Commands.data(), m_Commands.size() * sizeof(DrawElementsIndirectCommand));
+		Upload(m_DrawDataBuffer, GL_SHADER_STORAGE_BUFFER, m_DrawDataCapacity, m_DrawData.data(), m_DrawData.size() * sizeof(DrawData));
+		GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, m_DrawDataBuffer.Get());
+
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)m_Commands.size(), 0);
+	}
+	else
+	{
+		UniformHandle model = shader.GetUniform("drawModel");
+		UniformHandle color = shader.GetUniform("drawColor");
+		for (size_t i = 0; i < m_Commands.size(); i++)
+		{
+			const DrawElementsIndirectCommand& command = m_Commands[i];
+			shader.SetUniform(model, m_DrawData[i].model);
+			shader.SetUniform(color, m_DrawData[i].color);
+			glDrawElementsBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, (void*)(command.firstIndex * sizeof(GLuint)), command.baseVertex);
+		}
+	}
+
+	m_Commands.clear();
+	m_DrawData.clear();
+}
+
+RenderQueue::SortBenchmark RenderQueue::MeasureSort(size_t itemCount)
+{
+	const GLuint PROGRAMS = 16, TEXTURES = 64, VERTEX_ARRAYS = 32;
+	std::mt19937 random(1);
+	std::vector<Item> items(itemCount);
+	std::vector<SortEntry> order(itemCount), scratch;
+	std::vector<float> depths(itemCount);
+	for (size_t i = 0; i < itemCount; i++)
+	{
+		Item& item = items[i];
+		item.program = random() % PROGRAMS + 1;
+		item.texture = random() % TEXTURES;
+		item.vertexArray = random() % VERTEX_ARRAYS + 1;
+		depths[i] = (random() % 100000) * 0.01f;
+		order[i].index = (uint32_t)i;
+	}
+
+	SortBenchmark result;
+	CountStateChanges(order, items, result.unsorted);
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < itemCount; i++)
+		order[i].key = MakeSortKey(RenderPass::Opaque, items[i].program, items[i].texture, items[i].vertexArray, depths[i]);
+	RadixSort::Sort(order, scratch);
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	CountStateChanges(order, items, result.sorted);
+	return result;
+}
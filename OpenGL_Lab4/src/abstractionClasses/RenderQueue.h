@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+#include "MeshPool.h"
+#include "radixSort.h"
+
+// Command layout read by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+// Passes are drawn in this order
+enum class RenderPass
+{
+	Opaque,
+	Transparent
+};
+
+// State changes between consecutive draws of one flush
+struct RenderQueueStats
+{
+	unsigned int items = 0;
+	unsigned int drawCalls = 0;
+	unsigned int programChanges = 0;
+	unsigned int textureChanges = 0;
+	unsigned int vertexArrayChanges = 0;
+};
+
+/// <summary>
+/// Collects the frame's draws, sorts them by a 64 bit key and replays them with as few state changes as possible.
+/// Key bits, most significant first: pass (4), program (12), texture (12), vertex array (12), depth (24).
+/// Opaque draws are sorted front to back, transparent ones back to front.
+/// Consecutive draws of pooled meshes that share a program are submitted with one glMultiDrawElementsIndirect,
+/// their per-draw data goes to a shader storage buffer indexed by gl_DrawID (see pooled.shader).
+/// Without multi-draw support (GL 4.3 and ARB_shader_draw_parameters) they're issued one by one
+/// </summary>
+class RenderQueue
+{
+public:
+	// Shader storage binding point of the "Draws" block
+	static const unsigned int DRAW_DATA_BINDING = 0;
+	// View distance mapped to the full depth range of the key
+	static constexpr float MAX_SORT_DEPTH = 1000.f;
+
+	// Matches "struct DrawData" of pooled.shader in std430 layout
+	struct DrawData
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+	};
+
+	// Result of MeasureSort
+	struct SortBenchmark
+	{
+		double milliseconds;
+		RenderQueueStats unsorted;
+		RenderQueueStats sorted;
+	};
+private:
+	struct Item
+	{
+		Shader* shader;
+		// Exactly one of them is set
+		Mesh* mesh;
+		MeshPool* pool;
+		PooledMesh pooledMesh;
+		DrawData drawData;
+		GLuint program;
+		GLuint texture;
+		GLuint vertexArray;
+	};
+
+	std::vector<Item> m_Items;
+	std::vector<SortEntry> m_Order;
+	std::vector<SortEntry> m_SortScratch;
+
+	// Pooled run being collected, drawn by FlushPooled
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+	std::vector<DrawData> m_DrawData;
+	UniqueBuffer m_CommandBuffer;
+	UniqueBuffer m_DrawDataBuffer;
+	size_t m_CommandCapacity = 0;
+	size_t m_DrawDataCapacity = 0;
+
+	RenderQueueStats m_LastStats;
+	RenderQueueStats m_LastUnsortedStats;
+
+	// Grows the buffer's storage geometrically and orphans it, the previous frame's draws may still read it
+	static void Upload(UniqueBuffer& buffer, GLenum target, size_t& capacity, const void* data, size_t size);
+	// Counts the changes a replay in this order would make
+	static void CountStateChanges(const std::vector<SortEntry>& order, const std::vector<Item>& items, RenderQueueStats& stats);
+	void FlushPooled(Shader& shader, MeshPool& pool);
+public:
+	RenderQueue();
+
+	static uint64_t MakeSortKey(RenderPass pass, GLuint program, GLuint texture, GLuint vertexArray, float depth);
+
+	// depth is the distance from the camera, used to order draws with the same state
+	void Submit(Mesh& mesh, Shader& shader, float depth, RenderPass pass = RenderPass::Opaque);
+	void Submit(MeshPool& pool, const PooledMesh& mesh, Shader& shader, const glm::mat4& model, glm::vec4 color, float depth, RenderPass pass = RenderPass::Opaque);
+	// Sorts, draws and clears everything submitted since the last flush
+	void Flush();
+
+	static bool IsMultiDrawSupported();
+	// Defines pooled.shader has to be compiled with on this context
+	static std::vector<std::string> GetShaderDefines();
+
+	inline const RenderQueueStats& GetLastStats() const { return m_LastStats; }
+	// What the last flush would have cost in submission order
+	inline const RenderQueueStats& GetLastUnsortedStats() const { return m_LastUnsortedStats; }
+
+	// Builds and sorts itemCount synthetic items with random state, without drawing them
+	static SortBenchmark MeasureSort(size_t itemCount);
+};
@@ -2,87 +2,212 @@
 
 #include <iostream>
 #include <GL/glew.h>
-#include <fstream>
-#include <sstream>
 #include <string>
+#include <chrono>
+#include <cstring>
 
+#include "GLStateCache.h"
+#include "ShaderCache.h"
+#include "ShaderParser.h"
+#include "hash.h"
 
-Shader::Shader(const std::string& filepath) : m_FilePath(filepath), ID(0)
+unsigned int Shader::s_LocationQueries = 0;
+ShaderLoadStats Shader::s_LoadStats;
+
+Shader::Shader(const std::string& filepath, const std::vector<std::string>& defines, bool async) : m_FilePath(filepath), m_Defines(defines)
 {
-    ShaderProgamSource source = ParseShader(filepath);
-    ID = CreateShader(source.vertexSource, source.fragmentSource);
+    m_SubmitTime = std::chrono::steady_clock::now();
+
+    ShaderProgamSource source = ShaderParser::Parse(filepath, defines);
+
+    m_CacheKey = ShaderCache::MakeKey(source.vertexSource, source.fragmentSource);
+    ID = UniqueProgram(ShaderCache::Load(m_CacheKey));
+    m_FromCache = (bool)ID;
+    if (!m_FromCache)
+        ID = UniqueProgram(CreateShader(source.vertexSource, source.fragmentSource));
+
+    // A cached binary is already linked, so only fresh builds are left running
+    if (!async || m_FromCache)
+        Finalize();
 }
 
+void Shader::EnableParallelCompile()
+{
+    if (GLEW_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+}
 
 /// <summary>
-///       (vertex, fragment)
+/// Only submits the work: no status is queried here, because any query waits for the driver to finish.
+/// glValidateProgram is not called either, it checks the current GL state and not the program itself
 /// </summary>
-ShaderProgamSource Shader::ParseShader(const std::string filepath)
+unsigned int Shader::CreateShader(const std::string vertexShader, const std::string fragmentShader)
 {
-    enum class ShaderType
-    {
-        NONE = -1, VERTEX = 0, FRAGMENT = 1
-    };
+    unsigned int program = glCreateProgram();
+    m_VertexShader = CompileShader(GL_VERTEX_SHADER, vertexShader);
+    m_FragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+
+    glAttachShader(program, m_VertexShader);
+    glAttachShader(program, m_FragmentShader);
+    if (ShaderCache::IsSupported())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+
+    return program;
+}
 
-    std::ifstream stream(filepath);
-    std::string line;
-    std::stringstream ss[2];
-    ShaderType type = ShaderType::NONE;
+unsigned int Shader::CompileShader(unsigned int type, const std::string source)
+{
+    unsigned int id = glCreateShader(type);
+    const char* src = source.c_str();
+    glShaderSource(id, 1, &src, nullptr);
+    glCompileShader(id);
 
-    while (getline(stream, line))
+    return id;
+}
+
+bool Shader::IsReady()
+{
+    if (m_Ready)
+        return true;
+
+    if (GLEW_KHR_parallel_shader_compile)
     {
-        if (line.find("#shader") != std::string::npos)
+        int done = GL_FALSE;
+        // Stages finish before the link, this only timestamps the compile for the report
+        if (m_CompileTime < 0.0)
         {
-            if (line.find("vertex") != std::string::npos)
-                type = ShaderType::VERTEX;
-            else if (line.find("fragment") != std::string::npos)
-                type = ShaderType::FRAGMENT;
-        }
-        else
-        {
-            ss[(int)type] << line << "\n";
+            int vsDone = GL_FALSE, fsDone = GL_FALSE;
+            glGetShaderiv(m_VertexShader, GL_COMPLETION_STATUS_KHR, &vsDone);
+            glGetShaderiv(m_FragmentShader, GL_COMPLETION_STATUS_KHR, &fsDone);
+            if (vsDone && fsDone)
+                m_CompileTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_SubmitTime).count();
         }
+        glGetProgramiv(ID.Get(), GL_COMPLETION_STATUS_KHR, &done);
+        if (!done)
+            return false;
     }
 
-    return { ss[0].str(), ss[1].str() };
+    Finalize();
+    return true;
 }
 
-unsigned int Shader::CreateShader(const std::string vertexShader, const std::string fragmentShader)
+void Shader::WaitUntilReady()
 {
-    unsigned int program = glCreateProgram();
-    unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+    if (!m_Ready)
+        Finalize();
+}
 
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-    glValidateProgram(program);
+// Prints the full info log of a stage. Returns false if it didn't compile
+bool Shader::CheckStage(unsigned int shader, const char* stageName) const
+{
+    int compiled = GL_FALSE, logLength = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+    if (logLength > 1)
+    {
+        std::string log(logLength, '\0');
+        glGetShaderInfoLog(shader, logLength, nullptr, &log[0]);
+        std::cout << "Shader " << m_FilePath << " " << stageName << (compiled ? " warnings:\n" : " errors:\n") << log << std::endl;
+    }
+    return compiled == GL_TRUE;
+}
 
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+/// <summary>
+/// Waits for the link if it's still running, reports errors and timings,
+/// then reflects the uniforms and stores a fresh program in the binary cache
+/// </summary>
+void Shader::Finalize()
+{
+    m_Linked = true;
+    if (!m_FromCache)
+    {
+        bool compiled = CheckStage(m_VertexShader, "vertex") & CheckStage(m_FragmentShader, "fragment");
+        if (m_CompileTime < 0.0)
+            m_CompileTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_SubmitTime).count();
 
-    return program;
+        int linked = GL_FALSE, logLength = 0;
+        glGetProgramiv(ID.Get(), GL_LINK_STATUS, &linked);
+        glGetProgramiv(ID.Get(), GL_INFO_LOG_LENGTH, &logLength);
+        if (logLength > 1)
+        {
+            std::string log(logLength, '\0');
+            glGetProgramInfoLog(ID.Get(), logLength, nullptr, &log[0]);
+            std::cout << "Shader " << m_FilePath << " link " << (linked ? "warnings:\n" : "errors:\n") << log << std::endl;
+        }
+        m_Linked = compiled && linked == GL_TRUE;
+
+        glDetachShader(ID.Get(), m_VertexShader);
+        glDetachShader(ID.Get(), m_FragmentShader);
+        glDeleteShader(m_VertexShader);
+        glDeleteShader(m_FragmentShader);
+        m_VertexShader = m_FragmentShader = 0;
+
+        if (m_Linked)
+            ShaderCache::Store(ID.Get(), m_CacheKey);
+    }
+    if (m_Linked)
+        ReflectUniforms();
+    m_Ready = true;
+
+    // The timings are shown in the Stats window, only a failed build is reported here
+    m_LoadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_SubmitTime).count();
+    if (m_FromCache)
+    {
+        s_LoadStats.warmLoads++;
+        s_LoadStats.warmMilliseconds += m_LoadTime;
+    }
+    else
+    {
+        s_LoadStats.coldLoads++;
+        s_LoadStats.coldMilliseconds += m_LoadTime;
+    }
+    if (!m_Linked)
+        std::cout << "Shader " << m_FilePath << " FAILED to build" << std::endl;
 }
 
-unsigned int Shader::CompileShader(unsigned int type, const std::string source)
+void Shader::BindUniformBlock(const char* blockName, unsigned int bindingPoint)
 {
-    unsigned int id = glCreateShader(type);
-    const char* src = source.c_str();
-    glShaderSource(id, 1, &src, nullptr);
-    glCompileShader(id);
+    unsigned int blockIndex = glGetUniformBlockIndex(ID.Get(), blockName);
+    if (blockIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID.Get(), blockIndex, bindingPoint);
+}
 
+void Shader::BindStorageBlock(const char* blockName, unsigned int bindingPoint)
+{
+    unsigned int blockIndex = glGetProgramResourceIndex(ID.Get(), GL_SHADER_STORAGE_BLOCK, blockName);
+    if (blockIndex != GL_INVALID_INDEX)
+        glShaderStorageBlockBinding(ID.Get(), blockIndex, bindingPoint);
+}
 
-    int result;
-    glGetShaderiv(id, GL_COMPILE_STATUS, &result);
-    if (result == GL_FALSE)
-        std::cout << "SHADER ERROR" << std::endl;
+void Shader::Bind() const { GLStateCache::UseProgram(ID.Get()); }
 
-    return id;
+void Shader::Unbind() const { GLStateCache::UseProgram(0); }
+
+void Shader::SetUniform(UniformHandle handle, int value)
+{
+    glUniform1i(handle.location, value);
 }
 
-void Shader::Bind() const { glUseProgram(ID); }
+void Shader::SetUniform(UniformHandle handle, float value)
+{
+    glUniform1f(handle.location, value);
+}
 
-void Shader::Unbind() const { glUseProgram(0); }
+void Shader::SetUniform(UniformHandle handle, glm::vec3 vec)
+{
+    glUniform3f(handle.location, vec.x, vec.y, vec.z);
+}
+
+void Shader::SetUniform(UniformHandle handle, glm::vec4 vec)
+{
+    glUniform4f(handle.location, vec.x, vec.y, vec.z, vec.w);
+}
+
+void Shader::SetUniform(UniformHandle handle, const glm::mat4& matrix)
+{
+    glUniformMatrix4fv(handle.location, 1, GL_FALSE, &matrix[0][0]);
+}
 
 void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
 {
@@ -91,42 +216,141 @@ void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2,
 
 void Shader::SetUniform4f(const std::string& name, glm::vec4 vec)
 {
-    glUniform4f(GetUniformLocation(name), vec.x, vec.y, vec.z, vec.w);
+    SetUniform(UniformHandle{ GetUniformLocation(name) }, vec);
 }
 
 void Shader::SetUniform3f(const std::string& name, glm::vec3 vec)
 {
-    glUniform3f(GetUniformLocation(name), vec.x, vec.y, vec.z);
+    SetUniform(UniformHandle{ GetUniformLocation(name) }, vec);
 }
 
 void Shader::SetUniform1i(const std::string& name, int value)
 {
-    glUniform1i(GetUniformLocation(name), value);
+    SetUniform(UniformHandle{ GetUniformLocation(name) }, value);
 }
 
 void Shader::SetUniform1f(const std::string& name, float value)
 {
-    glUniform1f(GetUniformLocation(name), value);
+    SetUniform(UniformHandle{ GetUniformLocation(name) }, value);
 }
 
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 {
-    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
+    SetUniform(UniformHandle{ GetUniformLocation(name) }, matrix);
+}
+
+
+int Shader::QueryUniformLocation(unsigned int program, const char* name)
+{
+    s_LocationQueries++;
+    return glGetUniformLocation(program, name);
 }
 
+/// <summary>
+/// Fills the uniform table once after linking, so that no glGetUniformLocation is called per frame.
+/// Array elements are registered both as "name[i]" and, for the first one, as "name"
+/// </summary>
+void Shader::ReflectUniforms()
+{
+    int count = 0, maxNameLength = 0;
+    glGetProgramiv(ID.Get(), GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID.Get(), GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
 
+    std::vector<std::pair<std::string, int>> uniforms;
+    std::vector<char> nameBuffer(maxNameLength + 1);
+    for (int i = 0; i < count; i++)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        // Uniform block members have no location
+        GLuint index = i;
+        GLint blockIndex = -1;
+        glGetActiveUniformsiv(ID.Get(), 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+        if (blockIndex != -1)
+            continue;
 
+        glGetActiveUniform(ID.Get(), i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        bool isArray = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0;
+        if (isArray)
+        {
+            std::string baseName = name.substr(0, name.size() - 3);
+            for (int element = 0; element < size; element++)
+            {
+                std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                int location = QueryUniformLocation(ID.Get(), elementName.c_str());
+                if (location == -1)
+                    continue;
+                uniforms.push_back({ elementName, location });
+                if (element == 0)
+                    uniforms.push_back({ baseName, location });
+            }
+        }
+        else
+        {
+            int location = QueryUniformLocation(ID.Get(), name.c_str());
+            if (location != -1)
+                uniforms.push_back({ name, location });
+        }
+    }
+
+    // Power of two capacity with load factor <= 0.5
+    size_t capacity = 8;
+    while (capacity < uniforms.size() * 2)
+        capacity *= 2;
+    m_UniformSlots.assign(capacity, UniformSlot());
+    m_UniformNames.clear();
+
+    for (auto& uniform : uniforms)
+    {
+        uint64_t hash = HashString(uniform.first.c_str());
+        size_t slot = (size_t)hash & (capacity - 1);
+        while (m_UniformSlots[slot].location != -1)
+            slot = (slot + 1) & (capacity - 1);
+        m_UniformSlots[slot] = { hash, m_UniformNames.size(), uniform.second };
+        m_UniformNames.append(uniform.first).push_back('\0');
+    }
+}
+
+UniformHandle Shader::GetUniform(const char* name) const
+{
+    if (m_UniformSlots.empty())
+        return UniformHandle();
+
+    // Hashing a const char* never allocates
+    uint64_t hash = HashString(name);
+    size_t mask = m_UniformSlots.size() - 1;
+    for (size_t slot = (size_t)hash & mask; m_UniformSlots[slot].location != -1; slot = (slot + 1) & mask)
+    {
+        // Different names can share a hash, so a hit is confirmed by the name
+        const UniformSlot& candidate = m_UniformSlots[slot];
+        if (candidate.nameHash == hash && std::strcmp(m_UniformNames.c_str() + candidate.nameOffset, name) == 0)
+            return UniformHandle{ candidate.location };
+    }
+    return UniformHandle();
+}
 
 int Shader::GetUniformLocation(const std::string& name)
 {
-    int location = glGetUniformLocation(ID, name.c_str());
+    int location = GetUniform(name.c_str()).location;
     if (location == -1)
         std::cout << "UNIFORM " << name << " DOES NOT EXIST!";
     return location;
 }
 
+unsigned int Shader::GetLocationQueries() { return s_LocationQueries; }
+
+void Shader::ResetLocationQueries() { s_LocationQueries = 0; }
+
+const ShaderLoadStats& Shader::GetLoadStats() { return s_LoadStats; }
+
 
 Shader::~Shader()
 {
-    glDeleteProgram(ID);
+    if (m_VertexShader)
+        glDeleteShader(m_VertexShader);
+    if (m_FragmentShader)
+        glDeleteShader(m_FragmentShader);
 }
@@ -0,0 +1,149 @@
+#include "ShaderCache.h"
+#include "hash.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+std::string ShaderCache::s_Directory = "./shaderCache";
+
+static const uint32_t ENTRY_MAGIC = 0x42504C47; // "GLPB"
+
+struct EntryHeader
+{
+	uint32_t magic;
+	uint32_t format;
+	uint32_t size;
+};
+
+void ShaderCache::SetDirectory(const std::string& directory) { s_Directory = directory; }
+
+bool ShaderCache::IsSupported()
+{
+	if (!GLEW_ARB_get_program_binary)
+		return false;
+	GLint numFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+	return numFormats > 0;
+}
+
+std::string ShaderCache::GetEntryPath(uint64_t key)
+{
+	std::stringstream path;
+	path << s_Directory << "/" << std::hex << key << ".bin";
+	return path.str();
+}
+
+uint64_t ShaderCache::MakeKey(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	uint64_t key = HashBytes(vertexSource.data(), vertexSource.size());
+	key = HashBytes(fragmentSource.data(), fragmentSource.size(), key);
+	for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+	{
+		const char* value = (const char*)glGetString(name);
+		if (value)
+			key = HashString(value, key);
+	}
+	return key;
+}
+
+GLuint ShaderCache::Load(uint64_t key)
+{
+	if (!IsSupported())
+		return 0;
+
+	uint32_t format = 0;
+	std::vector<char> binary;
+	if (!ReadEntry(GetEntryPath(key), format, binary))
+		return 0;
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+
+	// Drivers reject binaries they can't use anymore, the caller then compiles from source
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+void ShaderCache::Store(GLuint program, uint64_t key)
+{
+	if (!IsSupported())
+		return;
+
+	GLint linked = GL_FALSE, size = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+	if (linked == GL_FALSE || size <= 0)
+		return;
+
+	std::vector<char> binary(size);
+	GLenum format = 0;
+	GLsizei length = 0;
+	glGetProgramBinary(program, size, &length, &format, binary.data());
+	binary.resize(length);
+
+	std::error_code error;
+	std::filesystem::create_directories(s_Directory, error);
+	WriteEntry(GetEntryPath(key), format, binary);
+}
+
+bool ShaderCache::WriteEntry(const std::string& path, uint32_t format, const std::vector<char>& binary)
+{
+	if (binary.empty())
+		return false;
+
+	std::string temporaryPath = path + ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		EntryHeader header = { ENTRY_MAGIC, format, (uint32_t)binary.size() };
+		file.write((const char*)&header, sizeof(header));
+		file.write(binary.data(), binary.size());
+		file.close();
+		if (!file.good())
+		{
+			std::error_code error;
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	// Replaces the old entry at once, a reader sees either the old or the new file
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+bool ShaderCache::ReadEntry(const std::string& path, uint32_t& format, std::vector<char>& binary)
+{
+	// Opened at the end to measure the entry
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+	std::streamoff fileSize = file.tellg();
+	file.seekg(0);
+
+	EntryHeader header;
+	if (fileSize < (std::streamoff)sizeof(header) || !file.read((char*)&header, sizeof(header)) || header.magic != ENTRY_MAGIC)
+		return false;
+	// The binary must fill the rest of the file exactly, so a truncated or corrupt size isn't allocated
+	if (header.size == 0 || (std::streamoff)header.size != fileSize - (std::streamoff)sizeof(header))
+		return false;
+
+	binary.resize(header.size);
+	if (!file.read(binary.data(), binary.size()))
+		return false;
+	format = header.format;
+	return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Persistent cache of linked program binaries (glGetProgramBinary/glProgramBinary).
+/// Entries are keyed by the final sources (defines included) and the driver's vendor, renderer and version,
+/// so a driver update or an edited shader simply misses and is compiled again
+/// </summary>
+class ShaderCache
+{
+private:
+	static std::string s_Directory;
+	static std::string GetEntryPath(uint64_t key);
+public:
+	static void SetDirectory(const std::string& directory);
+	static bool IsSupported();
+
+	static uint64_t MakeKey(const std::string& vertexSource, const std::string& fragmentSource);
+	// Returns a linked program or 0 if there is no usable entry
+	static GLuint Load(uint64_t key);
+	static void Store(GLuint program, uint64_t key);
+
+	// The entry file itself, a header followed by the binary. Doesn't touch GL.
+	// The entry is written to a temporary file and renamed over the old one, so a failed write never leaves a partial entry
+	static bool WriteEntry(const std::string& path, uint32_t format, const std::vector<char>& binary);
+	// Returns false if the entry is missing, truncated or its header doesn't match the file
+	static bool ReadEntry(const std::string& path, uint32_t& format, std::vector<char>& binary);
+};
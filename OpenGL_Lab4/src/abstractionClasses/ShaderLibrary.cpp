@@ -0,0 +1,49 @@
+#include "ShaderLibrary.h"
+
+#include <algorithm>
+#include <filesystem>
+
+std::unordered_map<std::string, std::weak_ptr<Shader>> ShaderLibrary::s_Shaders;
+
+// Defines are sorted, so their order doesn't produce different programs
+std::string ShaderLibrary::MakeKey(const std::string& filepath, const std::vector<std::string>& defines)
+{
+	std::error_code error;
+	std::string key = std::filesystem::weakly_canonical(filepath, error).generic_string();
+	if (error)
+		key = filepath;
+
+	std::vector<std::string> sortedDefines = defines;
+	std::sort(sortedDefines.begin(), sortedDefines.end());
+	for (auto& define : sortedDefines)
+		key += "|" + define;
+	return key;
+}
+
+std::shared_ptr<Shader> ShaderLibrary::Load(const std::string& filepath, const std::vector<std::string>& defines, bool async)
+{
+	std::string key = MakeKey(filepath, defines);
+
+	auto found = s_Shaders.find(key);
+	if (found != s_Shaders.end())
+	{
+		if (std::shared_ptr<Shader> shader = found->second.lock())
+		{
+			// The program may have been submitted asynchronously by someone else
+			if (!async)
+				shader->WaitUntilReady();
+			return shader;
+		}
+	}
+
+	// The last handle removes the entry and deletes the program right away
+	std::shared_ptr<Shader> shader(new Shader(filepath, defines, async), [key](Shader* shader)
+		{
+			s_Shaders.erase(key);
+			delete shader;
+		});
+	s_Shaders[key] = shader;
+	return shader;
+}
+
+size_t ShaderLibrary::GetLoadedCount() { return s_Shaders.size(); }
@@ -0,0 +1,22 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shader.h"
+
+/// <summary>
+/// Interns shader programs by canonical file path and defines, so identical programs are compiled once.
+/// Handles are reference counted, the program is deleted as soon as the last handle is released
+/// </summary>
+class ShaderLibrary
+{
+private:
+	static std::unordered_map<std::string, std::weak_ptr<Shader>> s_Shaders;
+	static std::string MakeKey(const std::string& filepath, const std::vector<std::string>& defines);
+public:
+	// An async load returns right after submitting the build, see Shader::IsReady
+	static std::shared_ptr<Shader> Load(const std::string& filepath, const std::vector<std::string>& defines = {}, bool async = false);
+	static size_t GetLoadedCount();
+};
@@ -0,0 +1,178 @@
+#include "ShaderParser.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+std::unordered_map<std::string, std::string> ShaderParser::s_IncludeCache;
+
+static std::string_view NextLine(std::string_view& text)
+{
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return line;
+}
+
+static std::string_view TrimLeft(std::string_view line)
+{
+    size_t start = line.find_first_not_of(" \t");
+    return start == std::string_view::npos ? std::string_view() : line.substr(start);
+}
+
+static bool StartsWith(std::string_view text, std::string_view prefix)
+{
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+static std::string GetDirectory(const std::string& filepath)
+{
+    return std::filesystem::path(filepath).parent_path().generic_string();
+}
+
+bool ShaderParser::ReadFile(const std::string& filepath, std::string& contents)
+{
+    std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+    if (!stream)
+        return false;
+
+    contents.resize((size_t)stream.tellg());
+    stream.seekg(0);
+    stream.read(&contents[0], contents.size());
+    return true;
+}
+
+const std::string* ShaderParser::GetInclude(const std::string& filepath)
+{
+    auto found = s_IncludeCache.find(filepath);
+    if (found != s_IncludeCache.end())
+        return &found->second;
+
+    std::string contents;
+    if (!ReadFile(filepath, contents))
+        return nullptr;
+    return &(s_IncludeCache[filepath] = std::move(contents));
+}
+
+void ShaderParser::AppendInclude(std::string_view directive, const std::string& directory, std::string& stage, std::unordered_set<std::string>& included)
+{
+    size_t nameStart = directive.find('"');
+    size_t nameEnd = nameStart == std::string_view::npos ? nameStart : directive.find('"', nameStart + 1);
+    if (nameEnd == std::string_view::npos)
+    {
+        std::cout << "SHADER ERROR: bad include " << directive << std::endl;
+        return;
+    }
+
+    std::filesystem::path path = std::filesystem::path(directory) / directive.substr(nameStart + 1, nameEnd - nameStart - 1);
+    std::error_code error;
+    std::string filepath = std::filesystem::weakly_canonical(path, error).generic_string();
+    if (error)
+        filepath = path.generic_string();
+
+    // Acts as an include guard
+    if (!included.insert(filepath).second)
+        return;
+
+    const std::string* contents = GetInclude(filepath);
+    if (!contents)
+    {
+        std::cout << "SHADER ERROR: can't open include " << filepath << std::endl;
+        return;
+    }
+    AppendText(*contents, GetDirectory(filepath), stage, included);
+}
+
+void ShaderParser::AppendText(std::string_view text, const std::string& directory, std::string& stage, std::unordered_set<std::string>& included)
+{
+    while (!text.empty())
+    {
+        std::string_view line = NextLine(text);
+        if (StartsWith(TrimLeft(line), "#include"))
+        {
+            AppendInclude(TrimLeft(line), directory, stage, included);
+            continue;
+        }
+        stage.append(line);
+        stage += '\n';
+    }
+}
+
+ShaderProgamSource ShaderParser::Parse(const std::string& filepath, const std::vector<std::string>& defines)
+{
+    enum ShaderType
+    {
+        NONE = -1, VERTEX = 0, FRAGMENT = 1
+    };
+
+    std::string file;
+    if (!ReadFile(filepath, file))
+    {
+        std::cout << "SHADER ERROR: can't open " << filepath << std::endl;
+        return {};
+    }
+
+    std::string directory = GetDirectory(filepath);
+    std::string stages[2];
+    std::unordered_set<std::string> included[2];
+    int type = NONE;
+
+    // Sections are found first, so each one is appended as a whole
+    std::string_view text = file;
+    const char* sectionStart = nullptr;
+    auto closeSection = [&](const char* sectionEnd)
+    {
+        if (type != NONE && sectionStart)
+            AppendText(std::string_view(sectionStart, sectionEnd - sectionStart), directory, stages[type], included[type]);
+    };
+
+    while (!text.empty())
+    {
+        const char* lineStart = text.data();
+        std::string_view line = TrimLeft(NextLine(text));
+        if (!StartsWith(line, "#shader"))
+            continue;
+
+        closeSection(lineStart);
+        if (line.find("vertex") != std::string_view::npos)
+            type = VERTEX;
+        else if (line.find("fragment") != std::string_view::npos)
+            type = FRAGMENT;
+        else
+        {
+            // Text of an unknown section is skipped
+            std::cout << "SHADER ERROR: unknown section " << line << " in " << filepath << std::endl;
+            type = NONE;
+        }
+        sectionStart = text.data();
+    }
+    closeSection(file.data() + file.size());
+
+    return { InjectDefines(stages[VERTEX], defines), InjectDefines(stages[FRAGMENT], defines) };
+}
+
+std::string ShaderParser::InjectDefines(std::string_view source, const std::vector<std::string>& defines)
+{
+    if (defines.empty())
+        return std::string(source);
+
+    std::string defineLines;
+    for (auto& define : defines)
+        defineLines += "#define " + define + "\n";
+
+    size_t version = source.find("#version");
+    size_t insertAt = version == std::string_view::npos ? 0 : source.find('\n', version);
+    if (insertAt == std::string_view::npos)
+        return std::string(source) + "\n" + defineLines;
+    if (version != std::string_view::npos)
+        insertAt++;
+
+    std::string result;
+    result.reserve(source.size() + defineLines.size());
+    result.append(source.substr(0, insertAt));
+    result.append(defineLines);
+    result.append(source.substr(insertAt));
+    return result;
+}
+
+void ShaderParser::ClearIncludeCache() { s_IncludeCache.clear(); }
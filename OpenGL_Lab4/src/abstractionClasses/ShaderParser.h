@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "shader.h"
+
+/// <summary>
+/// Splits a .shader file into its "#shader vertex" and "#shader fragment" sections.
+/// The file is read in one go and walked with string_views, "#include "file"" is expanded
+/// (every file at most once per stage) and defines are injected after #version
+/// </summary>
+class ShaderParser
+{
+private:
+	// Contents of included files, each file is read from disk only once
+	static std::unordered_map<std::string, std::string> s_IncludeCache;
+
+	static bool ReadFile(const std::string& filepath, std::string& contents);
+	static const std::string* GetInclude(const std::string& filepath);
+	static void AppendInclude(std::string_view directive, const std::string& directory, std::string& stage, std::unordered_set<std::string>& included);
+	static void AppendText(std::string_view text, const std::string& directory, std::string& stage, std::unordered_set<std::string>& included);
+public:
+	static ShaderProgamSource Parse(const std::string& filepath, const std::vector<std::string>& defines = {});
+	// Inserts "#define ..." lines right after the #version directive, which must stay the first line
+	static std::string InjectDefines(std::string_view source, const std::vector<std::string>& defines);
+	static void ClearIncludeCache();
+};
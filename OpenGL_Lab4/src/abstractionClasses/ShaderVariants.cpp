@@ -0,0 +1,73 @@
+#include "ShaderVariants.h"
+#include "ShaderLibrary.h"
+
+#include <algorithm>
+
+uint32_t ShaderVariants::MakeKey(bool hasTexture, int numOfLights)
+{
+	uint32_t key = hasTexture ? HAS_TEXTURE : 0;
+	key |= ((uint32_t)std::min(std::max(numOfLights, 0), (int)NUM_LIGHTS_MAX) << NUM_LIGHTS_SHIFT) & NUM_LIGHTS_MASK;
+	return key;
+}
+
+ShaderVariants::ShaderVariants(const std::string& filepath, const std::vector<std::string>& commonDefines, std::function<void(Shader&)> onCreate,
+	uint32_t fallbackKey)
+	: m_FilePath(filepath), m_CommonDefines(commonDefines), m_OnCreate(onCreate), m_FallbackKey(fallbackKey)
+{
+	GetBlocking(m_FallbackKey);
+}
+
+std::vector<std::string> ShaderVariants::GetDefines(uint32_t key) const
+{
+	std::vector<std::string> defines = m_CommonDefines;
+	if (key & HAS_TEXTURE)
+		defines.push_back("HAS_TEXTURE");
+	if (uint32_t numOfLights = (key & NUM_LIGHTS_MASK) >> NUM_LIGHTS_SHIFT)
+		defines.push_back("NUM_LIGHTS " + std::to_string(numOfLights));
+	return defines;
+}
+
+bool ShaderVariants::TryInitialize(Variant& variant)
+{
+	if (variant.initialized)
+		return true;
+	if (!variant.shader->IsReady())
+		return false;
+
+	if (m_OnCreate && variant.shader->IsLinked())
+		m_OnCreate(*variant.shader);
+	variant.initialized = true;
+	return true;
+}
+
+void ShaderVariants::Request(uint32_t key)
+{
+	if (m_Variants.find(key) == m_Variants.end())
+		m_Variants[key].shader = ShaderLibrary::Load(m_FilePath, GetDefines(key), true);
+}
+
+Shader& ShaderVariants::Get(uint32_t key)
+{
+	Request(key);
+	Variant& variant = m_Variants[key];
+	if (TryInitialize(variant) && variant.shader->IsLinked())
+		return *variant.shader;
+	return *m_Variants[m_FallbackKey].shader;
+}
+
+Shader& ShaderVariants::GetBlocking(uint32_t key)
+{
+	Request(key);
+	Variant& variant = m_Variants[key];
+	variant.shader->WaitUntilReady();
+	TryInitialize(variant);
+	return *variant.shader;
+}
+
+size_t ShaderVariants::GetPendingCount() const
+{
+	size_t pending = 0;
+	for (auto& variant : m_Variants)
+		pending += variant.second.initialized ? 0 : 1;
+	return pending;
+}
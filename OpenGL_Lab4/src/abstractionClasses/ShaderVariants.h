@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shader.h"
+
+/// <summary>
+/// Compile-time permutations of one shader file, selected by a bitmask key.
+/// Every key is compiled once (through ShaderLibrary) and then reused.
+/// Variants can be requested up front and compile in the background, the fallback is drawn until they're ready
+/// </summary>
+class ShaderVariants
+{
+public:
+	// Key layout: feature bits in the low byte, NUM_LIGHTS in the next 16 bits (0 - loop over numOfLights).
+	// 16 bits hold any light count a uniform block can fit, so no two counts share a variant
+	static const uint32_t HAS_TEXTURE = 1u << 0;
+	static const uint32_t NUM_LIGHTS_SHIFT = 8;
+	static const uint32_t NUM_LIGHTS_MAX = 0xFFFF;
+	static const uint32_t NUM_LIGHTS_MASK = NUM_LIGHTS_MAX << NUM_LIGHTS_SHIFT;
+
+	static uint32_t MakeKey(bool hasTexture, int numOfLights = 0);
+private:
+	std::string m_FilePath;
+	std::vector<std::string> m_CommonDefines;
+	std::function<void(Shader&)> m_OnCreate;
+
+	struct Variant
+	{
+		std::shared_ptr<Shader> shader;
+		bool initialized = false;
+	};
+	std::unordered_map<uint32_t, Variant> m_Variants;
+	uint32_t m_FallbackKey;
+
+	std::vector<std::string> GetDefines(uint32_t key) const;
+	// Runs onCreate once the program is linked. Returns false while it's still compiling
+	bool TryInitialize(Variant& variant);
+public:
+	// onCreate runs once for every new variant, e.g. to attach uniform blocks.
+	// The fallback variant is compiled right away, without waiting it's never needed
+	ShaderVariants(const std::string& filepath, const std::vector<std::string>& commonDefines = {}, std::function<void(Shader&)> onCreate = nullptr,
+		uint32_t fallbackKey = 0);
+
+	// Submits the variant without waiting for it
+	void Request(uint32_t key);
+	// Returns the variant if it's ready, the fallback otherwise
+	Shader& Get(uint32_t key);
+	// Returns the variant, waiting for it if needed
+	Shader& GetBlocking(uint32_t key);
+
+	size_t GetPendingCount() const;
+};
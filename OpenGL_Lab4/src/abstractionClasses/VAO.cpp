@@ -1,29 +1,41 @@
 #include "VAO.h"
+#include "GLStateCache.h"
 
-VAO::VAO()
+VAO::VAO() : m_ID(UniqueVertexArray::Create())
 {
-	glGenVertexArrays(1, &m_ID);
 }
 
-void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset)
+void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLboolean normalized)
 {
 	VBO.Bind();
-	glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
+	glVertexAttribPointer(layout, numComponents, type, normalized, stride, offset);
 	glEnableVertexAttribArray(layout);
 	VBO.Unbind();
 }
 
+void VAO::LinkAttribs(VBO& VBO, const VertexLayout& layout)
+{
+	for (const VertexAttribute& attribute : layout.GetAttributes())
+		LinkAttrib(VBO, attribute.layout, attribute.numComponents, attribute.type, layout.GetStride(), (void*)attribute.offset, attribute.normalized);
+}
+
+void VAO::LinkInstanceAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset)
+{
+	LinkAttrib(VBO, layout, numComponents, type, stride, offset);
+	glVertexAttribDivisor(layout, 1);
+}
+
 void VAO::Bind()
 {
-	glBindVertexArray(m_ID);
+	GLStateCache::BindVertexArray(m_ID.Get());
 }
 
 void VAO::Unbind()
 {
-	glBindVertexArray(0);
+	GLStateCache::BindVertexArray(0);
 }
 
 void VAO::Delete()
 {
-	glDeleteVertexArrays(1, &m_ID);
+	m_ID.Reset();
 }
\ No newline at end of file
@@ -2,11 +2,13 @@
 
 #include <GL/glew.h>
 #include "VBO.h"
+#include "GLHandles.h"
+#include "VertexLayout.h"
 
 class VAO
 {
 private:
-	GLuint m_ID;
+	UniqueVertexArray m_ID;
 
 public:
 
@@ -14,6 +16,11 @@ public:
 	void Bind();
 	void Unbind();
 	void Delete();
-	void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset);
+	inline GLuint GetID() const { return m_ID.Get(); }
+	void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLboolean normalized = GL_FALSE);
+	// Links every attribute of the layout
+	void LinkAttribs(VBO& VBO, const VertexLayout& layout);
+	// Attribute that advances once per instance instead of once per vertex
+	void LinkInstanceAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset);
 };
 
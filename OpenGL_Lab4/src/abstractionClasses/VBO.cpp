@@ -1,23 +1,58 @@
 #include "VBO.h"
+#include "GLStateCache.h"
+#include <algorithm>
 
-VBO::VBO(std::vector<Vertex>& vertices)
+VBO::VBO(const std::vector<Vertex>& vertices) : VBO(vertices.data(), vertices.size() * sizeof(Vertex))
 {
-	glGenBuffers(1, &m_ID);
-	glBindBuffer(GL_ARRAY_BUFFER, m_ID);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+}
+
+VBO::VBO(const void* data, size_t size)
+{
+	m_ID = UniqueBuffer::Create();
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_ID.Get());
+	m_Capacity = m_Size = size;
+	glBufferData(GL_ARRAY_BUFFER, m_Size, data, GL_STATIC_DRAW);
+}
+
+void VBO::Update(const std::vector<Vertex>& vertices)
+{
+	Update(vertices.data(), vertices.size() * sizeof(Vertex));
+}
+
+void VBO::Update(const void* data, size_t size)
+{
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_ID.Get());
+	if (size > m_Capacity)
+	{
+		m_Capacity = std::max(size, m_Capacity * 2);
+		glBufferData(GL_ARRAY_BUFFER, m_Capacity, nullptr, GL_DYNAMIC_DRAW);
+	}
+	else if (size != m_Size)
+	{
+		// Orphaning gives the buffer fresh storage, so the draws still reading the old data don't stall the upload
+		glBufferData(GL_ARRAY_BUFFER, m_Capacity, nullptr, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+	m_Size = size;
+}
+
+void VBO::Write(size_t offset, const void* data, size_t size)
+{
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_ID.Get());
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
 }
 
 void VBO::Bind()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, m_ID);
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_ID.Get());
 }
 
 void VBO::Unbind()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void VBO::Delete()
 {
-	glDeleteBuffers(1, &m_ID);
+	m_ID.Reset();
 }
@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include <vector>
 
+#include "GLHandles.h"
+
 struct Vertex
 {
 	glm::vec3 position;
@@ -13,9 +15,23 @@ struct Vertex
 class VBO
 {
 private:
-	GLuint m_ID;
+	UniqueBuffer m_ID;
+	// Bytes allocated and bytes used by the last upload
+	size_t m_Capacity = 0;
+	size_t m_Size = 0;
 public:
-	VBO(std::vector<Vertex>& vertices);
+	VBO() = default;
+	VBO(const std::vector<Vertex>& vertices);
+	// Raw vertex data, e.g. packed by a VertexLayout
+	VBO(const void* data, size_t size);
+
+	// Reuses the storage: in place if the size is the same, orphaned if it changed, grown geometrically if it doesn't fit
+	void Update(const std::vector<Vertex>& vertices);
+	void Update(const void* data, size_t size);
+	// Writes into the existing storage without resizing it, e.g. a suballocated range
+	void Write(size_t offset, const void* data, size_t size);
+	inline size_t GetCapacity() const { return m_Capacity; }
+	inline size_t GetSize() const { return m_Size; }
 	void Bind();
 	void Unbind();
 	void Delete();
@@ -0,0 +1,83 @@
+#include "VertexLayout.h"
+
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+VertexLayout::VertexLayout(VertexFormat format) : m_Format(format)
+{
+	switch (format)
+	{
+	case VertexFormat::Float:
+		Add(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
+		Add(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float));
+		Add(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
+		break;
+	case VertexFormat::Packed:
+		Add(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
+		Add(1, 2, GL_HALF_FLOAT, GL_FALSE, 2 * sizeof(uint16_t));
+		Add(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(uint32_t));
+		break;
+	case VertexFormat::PackedQuantized:
+		// Three shorts padded to 8 bytes to keep every attribute 4 byte aligned
+		Add(0, 3, GL_SHORT, GL_TRUE, 4 * sizeof(int16_t));
+		Add(1, 2, GL_HALF_FLOAT, GL_FALSE, 2 * sizeof(uint16_t));
+		Add(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(uint32_t));
+		break;
+	}
+}
+
+void VertexLayout::Add(GLuint layout, GLuint numComponents, GLenum type, GLboolean normalized, size_t size)
+{
+	m_Attributes.push_back(VertexAttribute{ layout, numComponents, type, normalized, (size_t)m_Stride });
+	m_Stride += (GLsizei)size;
+}
+
+std::vector<unsigned char> VertexLayout::Pack(const std::vector<Vertex>& vertices, glm::mat4& dequantization) const
+{
+	dequantization = glm::mat4(1.f);
+	std::vector<unsigned char> packed(vertices.size() * m_Stride);
+	if (m_Format == VertexFormat::Float)
+	{
+		if (!vertices.empty())
+			memcpy(packed.data(), vertices.data(), packed.size());
+		return packed;
+	}
+
+	// Positions are stored relative to the bounding box, scaled to [-1, 1]
+	glm::vec3 center(0.f), extent(1.f);
+	if (m_Format == VertexFormat::PackedQuantized && !vertices.empty())
+	{
+		glm::vec3 min = vertices[0].position, max = vertices[0].position;
+		for (const Vertex& vertex : vertices)
+		{
+			min = glm::min(min, vertex.position);
+			max = glm::max(max, vertex.position);
+		}
+		center = (min + max) * 0.5f;
+		extent = glm::max((max - min) * 0.5f, glm::vec3(1e-6f));
+		dequantization = glm::scale(glm::translate(glm::mat4(1.f), center), extent);
+	}
+
+	unsigned char* out = packed.data();
+	for (const Vertex& vertex : vertices)
+	{
+		if (m_Format == VertexFormat::PackedQuantized)
+		{
+			glm::vec3 q = glm::clamp((vertex.position - center) / extent, -1.f, 1.f);
+			int16_t position[4] = { (int16_t)glm::round(q.x * 32767.f), (int16_t)glm::round(q.y * 32767.f), (int16_t)glm::round(q.z * 32767.f), 0 };
+			memcpy(out, position, sizeof(position));
+		}
+		else
+		{
+			memcpy(out, &vertex.position, sizeof(glm::vec3));
+		}
+		uint32_t texUV = glm::packHalf2x16(vertex.texUV);
+		uint32_t normal = glm::packSnorm3x10_1x2(glm::vec4(vertex.normal, 0.f));
+		memcpy(out + m_Attributes[1].offset, &texUV, sizeof(texUV));
+		memcpy(out + m_Attributes[2].offset, &normal, sizeof(normal));
+		out += m_Stride;
+	}
+	return packed;
+}
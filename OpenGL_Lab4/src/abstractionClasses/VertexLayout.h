@@ -0,0 +1,49 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "VBO.h"
+
+enum class VertexFormat
+{
+	// vec3 position, vec2 texUV, vec3 normal in float32: 32 bytes
+	Float,
+	// float32 position, half float texUV, GL_INT_2_10_10_10_REV normal: 20 bytes
+	Packed,
+	// Packed with 16 bit positions, mapped back to model space by the dequantization matrix: 16 bytes
+	PackedQuantized
+};
+
+struct VertexAttribute
+{
+	GLuint layout;
+	GLuint numComponents;
+	GLenum type;
+	GLboolean normalized;
+	size_t offset;
+};
+
+/// <summary>
+/// Describes how a vertex is laid out in the VBO. Locations follow the shaders:
+/// 0 - position, 1 - texUV, 2 - normal
+/// </summary>
+class VertexLayout
+{
+private:
+	VertexFormat m_Format;
+	std::vector<VertexAttribute> m_Attributes;
+	GLsizei m_Stride = 0;
+
+	void Add(GLuint layout, GLuint numComponents, GLenum type, GLboolean normalized, size_t size);
+public:
+	VertexLayout(VertexFormat format = VertexFormat::Float);
+
+	inline VertexFormat GetFormat() const { return m_Format; }
+	inline const std::vector<VertexAttribute>& GetAttributes() const { return m_Attributes; }
+	inline GLsizei GetStride() const { return m_Stride; }
+
+	// Converts vertices to this layout. dequantization is set to the matrix that restores
+	// quantized positions (identity for other formats)
+	std::vector<unsigned char> Pack(const std::vector<Vertex>& vertices, glm::mat4& dequantization) const;
+};
@@ -1,7 +1,11 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
 
 #include "glm/glm.hpp"
+#include "GLHandles.h"
 
 struct ShaderProgamSource
 {
@@ -9,29 +13,113 @@ struct ShaderProgamSource
 	std::string fragmentSource;
 };
 
+// Resolved uniform location. Obtained once with Shader::GetUniform and reused every frame
+struct UniformHandle
+{
+	int location = -1;
+	inline bool IsValid() const { return location != -1; }
+};
+
+// Startup report: "cold" is a full compile and link, "warm" a program binary from the cache.
+// For async builds the times are measured from submission to the first poll that saw the work done
+struct ShaderLoadStats
+{
+	unsigned int coldLoads = 0;
+	unsigned int warmLoads = 0;
+	double coldMilliseconds = 0.0;
+	double warmMilliseconds = 0.0;
+};
+
 class Shader
 {
 private:
+	// Slot of the uniform table (open addressing, keyed by name hash). The name is compared on a hash hit
+	struct UniformSlot
+	{
+		uint64_t nameHash = 0;
+		// Of the zero-terminated name in m_UniformNames
+		size_t nameOffset = 0;
+		int location = -1;
+	};
+
 	std::string m_FilePath;
+	std::vector<std::string> m_Defines;
+	std::vector<UniformSlot> m_UniformSlots;
+	std::string m_UniformNames;
+
+	// Build state. Stages are kept until the program is finalized to read their info logs
+	unsigned int m_VertexShader = 0;
+	unsigned int m_FragmentShader = 0;
+	uint64_t m_CacheKey = 0;
+	bool m_Ready = false;
+	bool m_Linked = false;
+	bool m_FromCache = false;
+	std::chrono::steady_clock::time_point m_SubmitTime;
+	double m_CompileTime = -1.0;
+	double m_LoadTime = 0.0;
+
+	static unsigned int s_LocationQueries;
+	static ShaderLoadStats s_LoadStats;
 public:
-	unsigned int ID;
+	UniqueProgram ID;
 	Shader();
-	Shader(const std::string& filepath);
+	// Each define is injected as "#define <define>" into both stages, e.g. "MAX_LIGHTS 64".
+	// An async shader only submits the compile and link, use IsReady before drawing with it
+	Shader(const std::string& filepath, const std::vector<std::string>& defines = {}, bool async = false);
 	~Shader();
 
+	// Owns the GL program, so it can't be copied
+	Shader(const Shader&) = delete;
+	Shader& operator=(const Shader&) = delete;
+
 	void Bind() const;
 	void Unbind() const;
 
+	// Polls GL_COMPLETION_STATUS_KHR when it's supported, so it doesn't block while the driver compiles
+	bool IsReady();
+	// Blocks until the program is linked (or failed to link)
+	void WaitUntilReady();
+	inline bool IsLinked() const { return m_Ready && m_Linked; }
+	inline bool IsFromCache() const { return m_FromCache; }
+	// Compile time of a cold build and the whole load time, valid once the program is ready
+	inline double GetCompileTime() const { return m_CompileTime; }
+	inline double GetLoadTime() const { return m_LoadTime; }
+
+	// Lets the driver compile on all available threads, no-op without KHR_parallel_shader_compile
+	static void EnableParallelCompile();
+
+	// Connects a std140 uniform block of this program to a uniform buffer binding point
+	void BindUniformBlock(const char* blockName, unsigned int bindingPoint);
+	// Same for a shader storage block, needs GL 4.3 or ARB_shader_storage_buffer_object
+	void BindStorageBlock(const char* blockName, unsigned int bindingPoint);
+
+	UniformHandle GetUniform(const char* name) const;
+	inline bool HasUniform(const char* name) const { return GetUniform(name).IsValid(); }
+
+	void SetUniform(UniformHandle handle, int value);
+	void SetUniform(UniformHandle handle, float value);
+	void SetUniform(UniformHandle handle, glm::vec3 vec);
+	void SetUniform(UniformHandle handle, glm::vec4 vec);
+	void SetUniform(UniformHandle handle, const glm::mat4& matrix);
+
 	void SetUniform1i(const std::string& name, int value);
 	void SetUniform1f(const std::string& name, float value);
 	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
 	void SetUniform3f(const std::string& name, glm::vec3 vec);
 	void SetUniform4f(const std::string& name, glm::vec4 vec);
 	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+
+	// Number of glGetUniformLocation calls issued since the last reset
+	static unsigned int GetLocationQueries();
+	static void ResetLocationQueries();
+	// Totals of every program finalized so far
+	static const ShaderLoadStats& GetLoadStats();
 private:
 	unsigned int CompileShader(unsigned int type, const std::string source);
 	unsigned int CreateShader(const std::string vertexShader, const std::string fragmentShader);
-	ShaderProgamSource ParseShader(const std::string filepath);
+	void Finalize();
+	bool CheckStage(unsigned int shader, const char* stageName) const;
+	void ReflectUniforms();
+	static int QueryUniformLocation(unsigned int program, const char* name);
 	int GetUniformLocation(const std::string& name);
 };
-
@@ -1,6 +1,7 @@
 #include"Texture.h"
 #include <stb/stb_image.h>
 #include <iostream>
+#include"GLStateCache.h"
 Texture::Texture(const char* image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType)
 {
 	type = texType;
@@ -10,10 +11,10 @@ Texture::Texture(const char* image, GLenum texType, GLenum slot, GLenum format,
 	stbi_set_flip_vertically_on_load(true);
 	unsigned char* bytes = stbi_load(image, &widthImg, &heightImg, &numColCh, 0);
 	// Generates an OpenGL texture object
-	glGenTextures(1, &ID);
+	ID = UniqueTexture::Create();
 	// Assigns the texture to a Texture Unit
-	glActiveTexture(slot);
-	glBindTexture(texType, ID);
+	GLStateCache::ActiveTexture(slot - GL_TEXTURE0);
+	GLStateCache::BindTexture(texType, ID.Get());
 
 	// Configures the type of algorithm that is used to make the image smaller or bigger
 	glTexParameteri(texType, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
@@ -35,7 +36,7 @@ Texture::Texture(const char* image, GLenum texType, GLenum slot, GLenum format,
 	stbi_image_free(bytes);
 
 	// Unbinds the OpenGL Texture object so that it can't accidentally be modified
-	glBindTexture(texType, 0);
+	GLStateCache::BindTexture(texType, 0);
 }
 
 void Texture::texUnit(Shader& shader, const char* uniform, GLuint unit)
@@ -44,17 +45,22 @@ void Texture::texUnit(Shader& shader, const char* uniform, GLuint unit)
 	
 }
 
+void Texture::texUnit(Shader& shader, UniformHandle uniform, GLuint unit)
+{
+	shader.SetUniform(uniform, (int)unit);
+}
+
 void Texture::Bind()
 {
-	glBindTexture(type, ID);
+	GLStateCache::BindTexture(type, ID.Get());
 }
 
 void Texture::Unbind()
 {
-	glBindTexture(type, 0);
+	GLStateCache::BindTexture(type, 0);
 }
 
 void Texture::Delete()
 {
-	glDeleteTextures(1, &ID);
+	ID.Reset();
 }
\ No newline at end of file
@@ -2,15 +2,17 @@
 
 #include <GL/glew.h>
 #include "shader.h"
+#include "GLHandles.h"
 
 class Texture
 {
 public:
-	GLuint ID;
+	UniqueTexture ID;
 	GLenum type;
 	Texture(const char* image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType);
 
 	void texUnit(Shader& shader, const char* uniform, GLuint unit);
+	void texUnit(Shader& shader, UniformHandle uniform, GLuint unit);
 	void Bind();
 	void Unbind();
 	void Delete();
@@ -2,44 +2,81 @@
 #include "timeManager.h"
 
 Camera::Camera(int width, int height, glm::vec3 position)
+	: m_Position(position), m_Width(width), m_Height(height)
 {
-	this->width = width;
-	this->height = height;
-	this->position = position;
 }
 
-void Camera::UpdateMatrix(Shader& shader, const char* uniform)
+void Camera::SetPosition(glm::vec3 position)
 {
-	// Initializes matrices since otherwise they will be the null matrix
-	glm::mat4 view = glm::mat4(1.0f);
-	glm::mat4 projection = glm::mat4(1.0f);
+	if (position == m_Position)
+		return;
+	m_Position = position;
+	m_ViewDirty = true;
+	m_Version++;
+}
+
+void Camera::SetSize(int width, int height)
+{
+	if (width == m_Width && height == m_Height)
+		return;
+	m_Width = width;
+	m_Height = height;
+	m_ProjectionDirty = true;
+	m_Version++;
+}
+
+void Camera::UpdateMatrices() const
+{
+	if (!m_ViewDirty && !m_ProjectionDirty)
+		return;
 
 	// Makes camera look in the right direction from the right position
-	view = glm::lookAt(position, position + m_Orientation, m_Up);
-	//// Adds perspective to the scene
-	projection = glm::perspective(glm::radians(m_fovDeg), (float)width / height, m_nearPlane, m_farPlane);
+	if (m_ViewDirty)
+		m_View = glm::lookAt(m_Position, m_Position + m_Orientation, m_Up);
+	// Adds perspective to the scene
+	if (m_ProjectionDirty)
+		m_Projection = glm::perspective(glm::radians(m_fovDeg), (float)m_Width / m_Height, m_nearPlane, m_farPlane);
+
+	m_ViewProjection = m_Projection * m_View;
+	m_ViewDirty = false;
+	m_ProjectionDirty = false;
+}
 
-	// Exports the camera matrix to the Vertex Shader
-	glUniformMatrix4fv(glGetUniformLocation(shader.ID, uniform), 1, GL_FALSE, glm::value_ptr(projection * view));
+const glm::mat4& Camera::GetView() const
+{
+	UpdateMatrices();
+	return m_View;
 }
 
+const glm::mat4& Camera::GetProjection() const
+{
+	UpdateMatrices();
+	return m_Projection;
+}
 
+const glm::mat4& Camera::GetViewProjection() const
+{
+	UpdateMatrices();
+	return m_ViewProjection;
+}
 
 void Camera::HandleInputs(GLFWwindow* window, bool stopMouseInput)
 {
+	glm::vec3 movement = glm::vec3(0.f);
 	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-		position += Time::GetDeltaTime() * speed * m_Orientation;
+		movement += speed * m_Orientation;
 	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		position += Time::GetDeltaTime() * speed * -glm::normalize(glm::cross(m_Orientation, m_Up));
+		movement += speed * -glm::normalize(glm::cross(m_Orientation, m_Up));
 	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-		position += Time::GetDeltaTime() * speed * -m_Orientation;
+		movement += speed * -m_Orientation;
 	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-		position += Time::GetDeltaTime() * speed * glm::normalize(glm::cross(m_Orientation, m_Up));
+		movement += speed * glm::normalize(glm::cross(m_Orientation, m_Up));
 	if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
-		position += Time::GetDeltaTime() * speed * m_Up;
+		movement += speed * m_Up;
 	if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
-		position += Time::GetDeltaTime() * speed * -m_Up;
-	
+		movement += speed * -m_Up;
+	if (movement != glm::vec3(0.f))
+		SetPosition(m_Position + Time::GetDeltaTime() * movement);
 
 
 	if (stopMouseInput)
@@ -54,7 +91,7 @@ void Camera::HandleInputs(GLFWwindow* window, bool stopMouseInput)
 		// Prevents camera from jumping on the first click
 		if (m_firstClick)
 		{
-			glfwSetCursorPos(window, (width / 2), (height / 2));
+			glfwSetCursorPos(window, (m_Width / 2), (m_Height / 2));
 			m_firstClick = false;
 		}
 
@@ -66,8 +103,8 @@ void Camera::HandleInputs(GLFWwindow* window, bool stopMouseInput)
 
 		// Normalizes and shifts the coordinates of the cursor such that they begin in the middle of the screen
 		// and then "transforms" them into degrees 
-		float rotX = sensitivity * (float)(mouseY - (height / 2)) / height;
-		float rotY = sensitivity * (float)(mouseX - (width / 2)) / width;
+		float rotX = sensitivity * (float)(mouseY - (m_Height / 2)) / m_Height;
+		float rotY = sensitivity * (float)(mouseX - (m_Width / 2)) / m_Width;
 
 		// Calculates upcoming vertical change in the Orientation
 		glm::vec3 newOrientation = glm::rotate(m_Orientation, glm::radians(-rotX), glm::normalize(glm::cross(m_Orientation, m_Up)));
@@ -78,9 +115,14 @@ void Camera::HandleInputs(GLFWwindow* window, bool stopMouseInput)
 
 		// Rotates the Orientation left and right
 		m_Orientation = glm::rotate(m_Orientation, glm::radians(-rotY), m_Up);
+		if (rotX != 0.f || rotY != 0.f)
+		{
+			m_ViewDirty = true;
+			m_Version++;
+		}
 
 		// Sets mouse cursor to the middle of the screen so that it doesn't end up roaming around
-		glfwSetCursorPos(window, (width / 2), (height / 2));
+		glfwSetCursorPos(window, (m_Width / 2), (m_Height / 2));
 	}
 	else if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_RELEASE)
 	{
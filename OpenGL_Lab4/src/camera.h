@@ -7,7 +7,6 @@
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
-#include "shader.h"
 
 class Camera
 {
@@ -18,18 +17,40 @@ private:
 	const float m_farPlane = 1000.f;
 	const glm::vec3 m_Up = glm::vec3(0.0f, 1.0f, 0.0f);
 	glm::vec3 m_Orientation = glm::vec3(0.0f, 0.0f, -1.0f);
-public:
-	glm::vec3 position;
+	glm::vec3 m_Position;
+
+	int m_Width;
+	int m_Height;
 
-	int width;
-	int height;
+	// Matrices are rebuilt lazily, only after the position, orientation or size changed
+	mutable glm::mat4 m_View = glm::mat4(1.f);
+	mutable glm::mat4 m_Projection = glm::mat4(1.f);
+	mutable glm::mat4 m_ViewProjection = glm::mat4(1.f);
+	mutable bool m_ViewDirty = true;
+	mutable bool m_ProjectionDirty = true;
+	// Incremented on every change, lets CameraUniformBlock skip uploads of an unchanged camera
+	unsigned int m_Version = 0;
 
+	void UpdateMatrices() const;
+public:
 	float speed = 10.f;
 	float sensitivity = 100.f;
 
 	Camera(int width, int height, glm::vec3 position);
 
-	void UpdateMatrix(Shader& shader, const char* uniform);
+	inline glm::vec3 GetPosition() const { return m_Position; }
+	void SetPosition(glm::vec3 position);
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	void SetSize(int width, int height);
+
+	const glm::mat4& GetView() const;
+	const glm::mat4& GetProjection() const;
+	const glm::mat4& GetViewProjection() const;
+	inline unsigned int GetVersion() const { return m_Version; }
+
+	inline float GetFovDeg() const { return m_fovDeg; }
+	inline float GetNearPlane() const { return m_nearPlane; }
 	void HandleInputs(GLFWwindow* window, bool stopMouseInput = false);
 };
 
@@ -6,8 +6,17 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec2 aTex;
 layout(location = 2) in vec3 aNormal;
 
-uniform mat4 camMatrix;
+// std140 layout, mirrored by CameraUniformBlock on the CPU side
+layout(std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
 uniform mat4 model;
+// Restores quantized positions (see VertexLayout), identity for float positions
+uniform mat4 dequantization;
 
 out vec2 texCoord;
 out vec3 normal;
@@ -15,28 +24,36 @@ out vec3 currentPosition;
 
 void main()
 {
-	currentPosition = vec3(model * vec4(aPos, 1.f));
-	gl_Position = camMatrix * vec4(currentPosition, 1.f);
+	currentPosition = vec3(model * dequantization * vec4(aPos, 1.f));
+	gl_Position = viewProjection * vec4(currentPosition, 1.f);
 	texCoord = aTex;
 	normal = aNormal;
 }
 
 #shader fragment
 #version 330 core
-const int MAX_LIGHTS = 5;
+#ifndef MAX_LIGHTS
+#define MAX_LIGHTS 5
+#endif
 
+// std140 layout, mirrored by LightUniformBlock on the CPU side
 struct BasicLight
 {
-	float intencity;
 	vec3 position;
+	float intencity;
 	vec3 color;
 };
 
-uniform int numOfLights;
-uniform BasicLight lights[MAX_LIGHTS];
+layout(std140) uniform Lights
+{
+	int numOfLights;
+	BasicLight lights[MAX_LIGHTS];
+};
 
-uniform float hasTexture;
+// Permutations: HAS_TEXTURE samples tex0, NUM_LIGHTS fixes the light loop at compile time
+#ifdef HAS_TEXTURE
 uniform sampler2D tex0;
+#endif
 
 in vec2 texCoord;
 in vec3 normal;
@@ -57,9 +74,17 @@ void main()
 	float ambientLight = 0.15f;
 
 	vec3 diffuseLightsResult = vec3(0.f);
+#ifdef NUM_LIGHTS
+	for (int i = 0; i < NUM_LIGHTS; i++)
+#else
 	for (int i = 0; i < numOfLights; i++)
+#endif
 		diffuseLightsResult += CalculateDiffuseLight(lights[i]);
 
 	vec4 lightResult = vec4(diffuseLightsResult + ambientLight, 1.f);
-	FragColor = (hasTexture != 0.f ? texture(tex0, texCoord) : vec4(1.f)) * lightResult;
+#ifdef HAS_TEXTURE
+	FragColor = texture(tex0, texCoord) * lightResult;
+#else
+	FragColor = lightResult;
+#endif
 }
\ No newline at end of file
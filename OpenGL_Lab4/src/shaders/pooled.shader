@@ -0,0 +1,64 @@
+#shader vertex
+#version 330 core
+#ifdef MULTI_DRAW
+#extension GL_ARB_shader_storage_buffer_object : require
+#extension GL_ARB_shader_draw_parameters : require
+#endif
+
+layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec3 aNormal;
+
+#ifdef MULTI_DRAW
+struct DrawData
+{
+	mat4 model;
+	vec4 color;
+};
+
+// One entry per draw of the RenderQueue
+layout(std430) readonly buffer Draws
+{
+	DrawData draws[];
+};
+#else
+uniform mat4 drawModel;
+uniform vec4 drawColor;
+#endif
+
+// std140 layout, mirrored by CameraUniformBlock on the CPU side
+layout(std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
+
+out vec3 color;
+
+void main()
+{
+#ifdef MULTI_DRAW
+	mat4 model = draws[gl_DrawIDARB].model;
+	vec4 baseColor = draws[gl_DrawIDARB].color;
+#else
+	mat4 model = drawModel;
+	vec4 baseColor = drawColor;
+#endif
+	// Fixed directional light, enough to tell the pooled objects' shapes apart
+	vec3 normal = normalize(mat3(model) * aNormal);
+	color = baseColor.rgb * (0.3f + 0.7f * max(dot(normal, normalize(vec3(0.3f, 1.f, 0.5f))), 0.f));
+	gl_Position = viewProjection * model * vec4(aPos, 1.0f);
+}
+
+#shader fragment
+#version 330 core
+
+out vec4 FragColor;
+
+in vec3 color;
+
+void main()
+{
+	FragColor = vec4(color, 1.f);
+}
@@ -2,13 +2,32 @@
 #version 330 core
 
 layout(location = 0) in vec3 aPos;
+#ifdef INSTANCED
+// Per instance, see InstancedMesh
+layout(location = 3) in mat4 instanceModel;
+layout(location = 7) in vec4 instanceColor;
 
+out vec3 color;
+#else
 uniform mat4 model;
-uniform mat4 camMatrix;
+#endif
+// std140 layout, mirrored by CameraUniformBlock on the CPU side
+layout(std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
 
 void main()
 {
-	gl_Position = camMatrix * model * vec4(aPos, 1.0f);
+#ifdef INSTANCED
+	color = instanceColor.rgb;
+	gl_Position = viewProjection * instanceModel * vec4(aPos, 1.0f);
+#else
+	gl_Position = viewProjection * model * vec4(aPos, 1.0f);
+#endif
 }
 
 #shader fragment
@@ -16,10 +35,17 @@ void main()
 
 out vec4 FragColor;
 
+#ifdef INSTANCED
+in vec3 color;
+#else
 uniform vec3 lightColor;
+#endif
 
 void main()
 {
+#ifdef INSTANCED
+	FragColor = vec4(color, 1.f);
+#else
 	FragColor = vec4(lightColor, 1.f);
+#endif
 }
-
@@ -0,0 +1,37 @@
+#pragma once
+#include <deque>
+#include <mutex>
+
+/// <summary>
+/// Hands results from worker threads to the render thread, which polls it once per frame
+/// </summary>
+template<typename T>
+class CompletionQueue
+{
+private:
+	std::deque<T> m_Items;
+	mutable std::mutex m_Mutex;
+public:
+	void Push(T item)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Items.push_back(std::move(item));
+	}
+
+	// Never blocks on workers, returns false when nothing has completed
+	bool TryPop(T& item)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Items.empty())
+			return false;
+		item = std::move(m_Items.front());
+		m_Items.pop_front();
+		return true;
+	}
+
+	bool IsEmpty() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Items.empty();
+	}
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// 64-bit FNV-1a. The seed allows hashing several pieces of data into one key
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++)
+		seed = (seed ^ bytes[i]) * 1099511628211ull;
+	return seed;
+}
+
+// Same as HashBytes over a zero-terminated string, without measuring it first
+inline uint64_t HashString(const char* string, uint64_t seed = 14695981039346656037ull)
+{
+	for (; *string; string++)
+		seed = (seed ^ (unsigned char)*string) * 1099511628211ull;
+	return seed;
+}
@@ -0,0 +1,199 @@
+#include "meshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// Forsyth's scoring constants. The cache is modelled as LRU, bigger than the hardware one
+static const int CACHE_SIZE = 32;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+static float VertexScore(int cachePosition, unsigned int remainingValence)
+{
+	// Nothing left to draw with this vertex
+	if (remainingValence == 0)
+		return -1.f;
+
+	float score = 0.f;
+	if (cachePosition >= 0)
+	{
+		// The vertices of the last triangle get a fixed score, so the next triangle doesn't just reuse them
+		if (cachePosition < 3)
+			score = LAST_TRIANGLE_SCORE;
+		else
+			score = powf(1.f - (cachePosition - 3) / (float)(CACHE_SIZE - 3), CACHE_DECAY_POWER);
+	}
+	// Boost vertices with few triangles left, so lone triangles aren't left behind
+	score += VALENCE_BOOST_SCALE * powf((float)remainingValence, -VALENCE_BOOST_POWER);
+	return score;
+}
+
+bool MeshOptimizer::AreIndicesInRange(const std::vector<unsigned int>& indices, size_t vertexCount)
+{
+	return std::all_of(indices.begin(), indices.end(), [vertexCount](unsigned int index) { return index < vertexCount; });
+}
+
+// Every array below is indexed by vertex, so an out of range index is a caller bug
+static bool CheckIndices(const std::vector<unsigned int>& indices, size_t vertexCount)
+{
+	bool inRange = MeshOptimizer::AreIndicesInRange(indices, vertexCount);
+	assert(inRange && "index outside the vertex range");
+	return inRange;
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize)
+{
+	// Less than a triangle has nothing to average over, the ratios below would divide by zero
+	VertexCacheStats stats;
+	if (indices.size() < 3 || !CheckIndices(indices, vertexCount))
+		return stats;
+
+	// A vertex is cached while fewer than cacheSize vertices were inserted after it
+	std::vector<size_t> insertedAt(vertexCount, 0);
+	size_t clock = 0, misses = 0, uniqueVertices = 0;
+	for (unsigned int index : indices)
+	{
+		if (insertedAt[index] == 0)
+			uniqueVertices++;
+		if (insertedAt[index] == 0 || clock - insertedAt[index] >= cacheSize)
+		{
+			misses++;
+			insertedAt[index] = ++clock;
+		}
+	}
+
+	stats.acmr = (float)misses / (indices.size() / 3);
+	stats.atvr = (float)misses / uniqueVertices;
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0 || !CheckIndices(indices, vertexCount))
+		return;
+
+	// Triangles of every vertex, the first remainingValence entries of its range are the ones not drawn yet
+	std::vector<unsigned int> remainingValence(vertexCount, 0);
+	for (unsigned int index : indices)
+		remainingValence[index]++;
+	std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + remainingValence[vertex];
+	std::vector<unsigned int> adjacency(indices.size());
+	std::vector<size_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t i = 0; i < indices.size(); i++)
+		adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		vertexScore[vertex] = VertexScore(-1, remainingValence[vertex]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	int bestTriangle = 0;
+	for (size_t triangle = 0; triangle < triangleCount; triangle++)
+	{
+		const unsigned int* corners = &indices[triangle * 3];
+		triangleScore[triangle] = vertexScore[corners[0]] + vertexScore[corners[1]] + vertexScore[corners[2]];
+		if (triangleScore[triangle] > triangleScore[bestTriangle])
+			bestTriangle = (int)triangle;
+	}
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	std::vector<unsigned int> cache, newCache;
+	size_t scanCursor = 0;
+
+	while (result.size() < indices.size())
+	{
+		// Nothing in the cache has triangles left, continue with the next undrawn one
+		if (bestTriangle < 0)
+		{
+			while (emitted[scanCursor])
+				scanCursor++;
+			bestTriangle = (int)scanCursor;
+		}
+
+		const unsigned int* corners = &indices[bestTriangle * 3];
+		emitted[bestTriangle] = true;
+		result.insert(result.end(), corners, corners + 3);
+
+		newCache.clear();
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int vertex = corners[corner];
+
+			// Swap the triangle out of the vertex's remaining range
+			unsigned int* begin = &adjacency[adjacencyOffsets[vertex]];
+			unsigned int* last = begin + remainingValence[vertex] - 1;
+			*std::find(begin, last + 1, (unsigned int)bestTriangle) = *last;
+			*last = (unsigned int)bestTriangle;
+			remainingValence[vertex]--;
+
+			if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+				newCache.push_back(vertex);
+		}
+		for (unsigned int vertex : cache)
+		{
+			if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+				newCache.push_back(vertex);
+		}
+
+		for (size_t i = 0; i < newCache.size(); i++)
+		{
+			unsigned int vertex = newCache[i];
+			cachePosition[vertex] = i < CACHE_SIZE ? (int)i : -1;
+			vertexScore[vertex] = VertexScore(cachePosition[vertex], remainingValence[vertex]);
+		}
+
+		// Only triangles touching the cache changed their score
+		bestTriangle = -1;
+		float bestScore = -1.f;
+		for (unsigned int vertex : newCache)
+		{
+			for (size_t i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex] + remainingValence[vertex]; i++)
+			{
+				unsigned int triangle = adjacency[i];
+				const unsigned int* triangleCorners = &indices[triangle * 3];
+				triangleScore[triangle] = vertexScore[triangleCorners[0]] + vertexScore[triangleCorners[1]] + vertexScore[triangleCorners[2]];
+				if (triangleScore[triangle] > bestScore)
+				{
+					bestScore = triangleScore[triangle];
+					bestTriangle = (int)triangle;
+				}
+			}
+		}
+
+		if (newCache.size() > CACHE_SIZE)
+			newCache.resize(CACHE_SIZE);
+		cache.swap(newCache);
+	}
+
+	indices.swap(result);
+}
+
+size_t MeshOptimizer::BuildFetchRemap(std::vector<unsigned int>& indices, size_t vertexCount, std::vector<unsigned int>& remap)
+{
+	if (!CheckIndices(indices, vertexCount))
+	{
+		remap.resize(vertexCount);
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+			remap[vertex] = (unsigned int)vertex;
+		return vertexCount;
+	}
+
+	remap.assign(vertexCount, ~0u);
+	unsigned int next = 0;
+	for (unsigned int& index : indices)
+	{
+		if (remap[index] == ~0u)
+			remap[index] = next++;
+		index = remap[index];
+	}
+	return next;
+}
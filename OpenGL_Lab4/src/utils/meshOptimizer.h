@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+struct VertexCacheStats
+{
+	// Average cache miss ratio: transformed vertices per triangle, 0.5 is the best possible for large grids, 3 the worst
+	float acmr = 0.f;
+	// Average transform to vertex ratio: transformed vertices per unique vertex, 1 is ideal
+	float atvr = 0.f;
+};
+
+/// <summary>
+/// Reorders index and vertex buffers for the GPU. OptimizeVertexCache is Forsyth's linear-speed
+/// vertex cache optimisation, OptimizeVertexFetch then puts vertices in the order they are first used
+/// </summary>
+class MeshOptimizer
+{
+private:
+	// Rewrites the indices and returns the new position of every vertex (~0u for unused ones).
+	// Out of range indices keep the current order
+	static size_t BuildFetchRemap(std::vector<unsigned int>& indices, size_t vertexCount, std::vector<unsigned int>& remap);
+public:
+	// Every index is below vertexCount. The other functions assert it in debug builds and leave the input unchanged in release builds
+	static bool AreIndicesInRange(const std::vector<unsigned int>& indices, size_t vertexCount);
+
+	// Simulates a FIFO post-transform cache of cacheSize entries
+	static VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize = 16);
+
+	static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+	// Unused vertices are removed
+	template<typename T>
+	static void OptimizeVertexFetch(std::vector<T>& vertices, std::vector<unsigned int>& indices)
+	{
+		std::vector<unsigned int> remap;
+		size_t vertexCount = BuildFetchRemap(indices, vertices.size(), remap);
+
+		std::vector<T> reordered(vertexCount);
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			if (remap[i] != ~0u)
+				reordered[remap[i]] = vertices[i];
+		}
+		vertices.swap(reordered);
+	}
+};
@@ -0,0 +1,45 @@
+#include "radixSort.h"
+
+#include <utility>
+
+void RadixSort::Sort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+{
+	const int PASSES = 8;
+	size_t count = entries.size();
+	if (count < 2)
+		return;
+
+	size_t histograms[PASSES][256] = {};
+	for (const SortEntry& entry : entries)
+	{
+		for (int pass = 0; pass < PASSES; pass++)
+			histograms[pass][(entry.key >> (pass * 8)) & 0xFF]++;
+	}
+
+	scratch.resize(count);
+	std::vector<SortEntry>* source = &entries;
+	std::vector<SortEntry>* destination = &scratch;
+	for (int pass = 0; pass < PASSES; pass++)
+	{
+		size_t* histogram = histograms[pass];
+		int shift = pass * 8;
+		if (histogram[((*source)[0].key >> shift) & 0xFF] == count)
+			continue;
+
+		// Turns the counts into the first output position of every bucket
+		size_t offset = 0;
+		for (int bucket = 0; bucket < 256; bucket++)
+		{
+			size_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (const SortEntry& entry : *source)
+			(*destination)[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+		std::swap(source, destination);
+	}
+
+	if (source != &entries)
+		entries.swap(scratch);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SortEntry
+{
+	uint64_t key;
+	// Position of the sorted element in the caller's array
+	uint32_t index;
+};
+
+/// <summary>
+/// LSD radix sort of 64 bit keys, one byte per pass. All byte histograms are built in a single read of the
+/// keys, and passes where every key has the same byte are skipped, so keys with few distinct high bits sort faster
+/// </summary>
+class RadixSort
+{
+public:
+	// Stable. scratch is only storage, reusing it between calls avoids the allocation
+	static void Sort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+};
@@ -0,0 +1,53 @@
+#include "rangeAllocator.h"
+
+#include <iterator>
+
+RangeAllocator::RangeAllocator(size_t capacity) : m_Capacity(capacity)
+{
+	if (capacity > 0)
+		m_Free[0] = capacity;
+}
+
+size_t RangeAllocator::Allocate(size_t size)
+{
+	if (size == 0)
+		return INVALID;
+
+	for (auto range = m_Free.begin(); range != m_Free.end(); ++range)
+	{
+		if (range->second < size)
+			continue;
+
+		size_t offset = range->first, remaining = range->second - size;
+		m_Free.erase(range);
+		if (remaining > 0)
+			m_Free[offset + size] = remaining;
+		m_Used += size;
+		return offset;
+	}
+	return INVALID;
+}
+
+void RangeAllocator::Free(size_t offset, size_t size)
+{
+	if (offset == INVALID || size == 0)
+		return;
+	m_Used -= size;
+
+	auto next = m_Free.lower_bound(offset);
+	if (next != m_Free.end() && offset + size == next->first)
+	{
+		size += next->second;
+		next = m_Free.erase(next);
+	}
+	if (next != m_Free.begin())
+	{
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset)
+		{
+			previous->second += size;
+			return;
+		}
+	}
+	m_Free[offset] = size;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <map>
+
+/// <summary>
+/// First-fit allocator of [offset, offset + size) ranges inside a fixed capacity.
+/// Freed ranges are merged with free neighbours, so the space doesn't fragment into unusable slivers
+/// </summary>
+class RangeAllocator
+{
+public:
+	static const size_t INVALID = ~(size_t)0;
+private:
+	// Size of every free range, by offset
+	std::map<size_t, size_t> m_Free;
+	size_t m_Capacity = 0;
+	size_t m_Used = 0;
+public:
+	RangeAllocator(size_t capacity = 0);
+
+	// Returns the offset of the range or INVALID if no free range is large enough
+	size_t Allocate(size_t size);
+	void Free(size_t offset, size_t size);
+
+	inline size_t GetCapacity() const { return m_Capacity; }
+	inline size_t GetUsed() const { return m_Used; }
+};
@@ -0,0 +1,50 @@
+#include "threadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	m_Workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; i++)
+		m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_TaskAdded.notify_all();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Tasks.push_back(std::move(task));
+	}
+	m_TaskAdded.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_TaskAdded.wait(lock, [this] { return m_Stopping || !m_Tasks.empty(); });
+			if (m_Tasks.empty())
+				return;
+			task = std::move(m_Tasks.front());
+			m_Tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Fixed set of worker threads running submitted tasks in FIFO order.
+/// Tasks must not block waiting for other tasks of the same pool
+/// </summary>
+class ThreadPool
+{
+private:
+	std::vector<std::thread> m_Workers;
+	std::deque<std::function<void()>> m_Tasks;
+	std::mutex m_Mutex;
+	std::condition_variable m_TaskAdded;
+	bool m_Stopping = false;
+
+	void WorkerLoop();
+public:
+	// 0 uses one thread per hardware core
+	explicit ThreadPool(unsigned int threadCount = 0);
+	// Finishes the queued tasks before joining the workers
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void Submit(std::function<void()> task);
+	inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size(); }
+};
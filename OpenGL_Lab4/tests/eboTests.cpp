@@ -0,0 +1,27 @@
+#include "test.h"
+#include "EBO.h"
+
+TEST(ChooseIndexTypeByteShortBoundary)
+{
+	CHECK(EBO::ChooseIndexType({}) == GL_UNSIGNED_BYTE);
+	CHECK(EBO::ChooseIndexType({ 0, 1, 2 }) == GL_UNSIGNED_BYTE);
+	CHECK(EBO::ChooseIndexType({ 0, 255, 2 }) == GL_UNSIGNED_BYTE);
+	CHECK(EBO::ChooseIndexType({ 0, 256, 2 }) == GL_UNSIGNED_SHORT);
+}
+
+TEST(ChooseIndexTypeShortIntBoundary)
+{
+	CHECK(EBO::ChooseIndexType({ 65535, 0, 1 }) == GL_UNSIGNED_SHORT);
+	CHECK(EBO::ChooseIndexType({ 65536, 0, 1 }) == GL_UNSIGNED_INT);
+	CHECK(EBO::ChooseIndexType({ 0xFFFFFFFF }) == GL_UNSIGNED_INT);
+}
+
+TEST(ChooseIndexTypePrimitiveRestart)
+{
+	// The largest value of each type is the restart index, so it can't address a vertex
+	CHECK(EBO::ChooseIndexType({ 254 }, true) == GL_UNSIGNED_BYTE);
+	CHECK(EBO::ChooseIndexType({ 255 }, true) == GL_UNSIGNED_SHORT);
+	CHECK(EBO::ChooseIndexType({ 65534 }, true) == GL_UNSIGNED_SHORT);
+	CHECK(EBO::ChooseIndexType({ 65535 }, true) == GL_UNSIGNED_INT);
+	CHECK(EBO::ChooseIndexType({}, true) == GL_UNSIGNED_BYTE);
+}
@@ -0,0 +1,74 @@
+#include "test.h"
+#include "GLHandles.h"
+
+#include <random>
+
+// Hands out increasing names without touching GL, so handles can be created without a context
+struct FakeBufferTraits
+{
+	static const GLResourceKind KIND = GLResourceKind::Buffer;
+	static GLuint nextId;
+	static int deleted;
+	static GLuint Create() { return nextId++; }
+	static void Delete(GLuint) { deleted++; }
+};
+GLuint FakeBufferTraits::nextId = 1;
+int FakeBufferTraits::deleted = 0;
+
+using FakeBuffer = UniqueHandle<FakeBufferTraits>;
+
+TEST(UniqueHandleMoveTransfersOwnership)
+{
+	int liveBefore = GLResourceRegistry::GetLiveCount(GLResourceKind::Buffer);
+	int deletedBefore = FakeBufferTraits::deleted;
+	{
+		FakeBuffer first = FakeBuffer::Create();
+		GLuint id = first.Get();
+		FakeBuffer second = std::move(first);
+		CHECK(!first);
+		CHECK(second.Get() == id);
+		CHECK(GLResourceRegistry::GetLiveCount(GLResourceKind::Buffer) == liveBefore + 1);
+
+		// Assigning over a live handle deletes its object
+		second = FakeBuffer::Create();
+		CHECK(FakeBufferTraits::deleted == deletedBefore + 1);
+		CHECK(GLResourceRegistry::GetLiveCount(GLResourceKind::Buffer) == liveBefore + 1);
+	}
+	CHECK(FakeBufferTraits::deleted == deletedBefore + 2);
+	CHECK(GLResourceRegistry::GetLiveCount(GLResourceKind::Buffer) == liveBefore);
+}
+
+TEST(UniqueHandleSoakReturnsLiveCountToZero)
+{
+	const int ITERATIONS = 100000;
+	int liveBefore = GLResourceRegistry::GetLiveCount(GLResourceKind::Buffer);
+	int deletedBefore = FakeBufferTraits::deleted;
+	GLuint firstId = FakeBufferTraits::nextId;
+	{
+		// Random creates, moves, resets and destroys, like meshes being rebuilt every frame
+		std::mt19937 random(1);
+		std::vector<FakeBuffer> handles(64);
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+			FakeBuffer& handle = handles[random() % handles.size()];
+			switch (random() % 4)
+			{
+			case 0: handle = FakeBuffer::Create(); break;
+			case 1: handles[random() % handles.size()] = std::move(handle); break;
+			case 2: handle.Reset(); break;
+			case 3:
+			{
+				// Moves the handle through a vector reallocation
+				FakeBuffer moved = std::move(handle);
+				handles.erase(handles.begin());
+				handles.push_back(std::move(moved));
+				break;
+			}
+			}
+		}
+	}
+	int created = (int)(FakeBufferTraits::nextId - firstId);
+	CHECK(created > 0);
+	CHECK(FakeBufferTraits::deleted - deletedBefore == created);
+	CHECK(GLResourceRegistry::GetLiveCount(GLResourceKind::Buffer) == liveBefore);
+}
@@ -0,0 +1,129 @@
+#include "test.h"
+#include "GLStateCache.h"
+
+#include <string>
+
+// Every call that reaches the mock table, e.g. "UseProgram 3"
+static std::vector<std::string> calls;
+
+static void Record(const char* name, GLuint a)
+{
+	calls.push_back(std::string(name) + " " + std::to_string(a));
+}
+
+static void Record(const char* name, GLuint a, GLuint b)
+{
+	calls.push_back(std::string(name) + " " + std::to_string(a) + " " + std::to_string(b));
+}
+
+static const GLStateFunctions mockFunctions =
+{
+	[](GLuint program) { Record("UseProgram", program); },
+	[](GLuint vertexArray) { Record("BindVertexArray", vertexArray); },
+	[](GLenum target, GLuint buffer) { Record("BindBuffer", target, buffer); },
+	[](GLenum, GLuint index, GLuint buffer) { Record("BindBufferBase", index, buffer); },
+	[](GLenum unit) { Record("ActiveTexture", unit - GL_TEXTURE0); },
+	[](GLenum target, GLuint texture) { Record("BindTexture", target, texture); },
+	[](GLenum, GLenum mode) { Record("PolygonMode", mode); },
+	[](GLenum capability) { Record("Enable", capability); },
+	[](GLenum capability) { Record("Disable", capability); },
+	[](GLenum sourceFactor, GLenum destinationFactor) { Record("BlendFunc", sourceFactor, destinationFactor); },
+	[](GLenum function) { Record("DepthFunc", function); }
+};
+
+// Installs the mock table with an empty call log and zeroed counters
+static void UseMock()
+{
+	GLStateCache::SetFunctions(mockFunctions);
+	GLStateCache::ResetFrameCounters();
+	calls.clear();
+}
+
+TEST(GLStateCacheElidesRedundantBinds)
+{
+	UseMock();
+	GLStateCache::UseProgram(3);
+	GLStateCache::UseProgram(3);
+	GLStateCache::BindVertexArray(2);
+	GLStateCache::BindVertexArray(2);
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 7);
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 7);
+	GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, 7);
+	GLStateCache::PolygonMode(GL_LINE);
+	GLStateCache::PolygonMode(GL_LINE);
+	GLStateCache::SetBlend(true);
+	GLStateCache::SetBlend(true);
+	GLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLStateCache::UseProgram(4);
+
+	CHECK(calls.size() == 8);
+	CHECK(calls.back() == "UseProgram 4");
+	CHECK(GLStateCache::GetIssuedCalls() == 8);
+	CHECK(GLStateCache::GetElidedCalls() == 6);
+	GLStateCache::SetFunctions(GLStateCache::GetDefaultFunctions());
+}
+
+TEST(GLStateCacheInvalidateReissues)
+{
+	UseMock();
+	GLStateCache::UseProgram(3);
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 7);
+	GLStateCache::Invalidate();
+	GLStateCache::UseProgram(3);
+	GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 7);
+
+	CHECK(calls.size() == 4);
+	CHECK(GLStateCache::GetElidedCalls() == 0);
+	GLStateCache::SetFunctions(GLStateCache::GetDefaultFunctions());
+}
+
+TEST(GLStateCacheTracksTexturesPerUnit)
+{
+	UseMock();
+	// Texture 0 is a real binding, the unknown initial state must not match it
+	GLStateCache::ActiveTexture(0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::ActiveTexture(1);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::ActiveTexture(0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+	CHECK((calls == std::vector<std::string>{ "ActiveTexture 0", "BindTexture " + std::to_string(GL_TEXTURE_2D) + " 0",
+		"ActiveTexture 1", "BindTexture " + std::to_string(GL_TEXTURE_2D) + " 0",
+		"ActiveTexture 0", "BindTexture " + std::to_string(GL_TEXTURE_CUBE_MAP) + " 0" }));
+	GLStateCache::SetFunctions(GLStateCache::GetDefaultFunctions());
+}
+
+TEST(GLStateCacheVertexArrayOwnsElementBuffer)
+{
+	UseMock();
+	GLStateCache::BindVertexArray(1);
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+	GLStateCache::BindVertexArray(2);
+	GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+
+	CHECK(calls.size() == 4);
+	GLStateCache::SetFunctions(GLStateCache::GetDefaultFunctions());
+}
+
+TEST(GLStateCacheForgetsDeletedObjects)
+{
+	UseMock();
+	GLStateCache::UseProgram(4);
+	GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, 9);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 6);
+	GLStateCache::OnProgramDeleted(4);
+	GLStateCache::OnBufferDeleted(9);
+	GLStateCache::OnTextureDeleted(6);
+	// GL reuses deleted names, so these are new objects
+	GLStateCache::UseProgram(4);
+	GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, 9);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 6);
+
+	CHECK(calls.size() == 6);
+	CHECK(GLStateCache::GetElidedCalls() == 0);
+	GLStateCache::SetFunctions(GLStateCache::GetDefaultFunctions());
+}
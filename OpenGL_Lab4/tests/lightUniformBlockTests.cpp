@@ -0,0 +1,87 @@
+#include "test.h"
+#include "LightUniformBlock.h"
+#include "GLStateCache.h"
+
+#include <cstdlib>
+#include <new>
+
+// Every allocation of the test executable goes through here, tests compare the count around the code they measure
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+	allocations++;
+	if (void* memory = std::malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+// GLEW entry points used by LightUniformBlock, pointed at fakes so the block can be driven without a context
+static int bufferSubDataCalls = 0;
+
+static void GLAPIENTRY FakeGenBuffers(GLsizei count, GLuint* buffers)
+{
+	for (GLsizei i = 0; i < count; i++)
+		buffers[i] = 1;
+}
+static void GLAPIENTRY FakeDeleteBuffers(GLsizei, const GLuint*) {}
+static void GLAPIENTRY FakeBindBuffer(GLenum, GLuint) {}
+static void GLAPIENTRY FakeBindBufferBase(GLenum, GLuint, GLuint) {}
+static void GLAPIENTRY FakeBufferData(GLenum, GLsizeiptr, const void*, GLenum) {}
+static void GLAPIENTRY FakeBufferSubData(GLenum, GLintptr, GLsizeiptr, const void*) { bufferSubDataCalls++; }
+
+static void UseFakeBuffers()
+{
+	__glewGenBuffers = FakeGenBuffers;
+	__glewDeleteBuffers = FakeDeleteBuffers;
+	__glewBindBuffer = FakeBindBuffer;
+	__glewBindBufferBase = FakeBindBufferBase;
+	__glewBufferData = FakeBufferData;
+	__glewBufferSubData = FakeBufferSubData;
+	GLStateCache::Invalidate();
+	bufferSubDataCalls = 0;
+}
+
+// Sets what LightCube and Main.cpp set every frame while the lights are animated
+static void AnimateLights(LightUniformBlock& lights, int frame)
+{
+	lights.SetNumOfLights(lights.GetMaxLights());
+	for (int i = 0; i < lights.GetMaxLights(); i++)
+	{
+		float phase = frame * 0.1f + i;
+		lights.SetPosition(i, glm::vec3(phase, 1.f, -phase));
+		lights.SetColor(i, glm::vec3(1.f, phase, 0.5f));
+		lights.SetIntencity(i, phase);
+	}
+	lights.Upload();
+}
+
+TEST(LightUniformBlockSteadyFrameDoesNotAllocate)
+{
+	UseFakeBuffers();
+	LightUniformBlock lights(16);
+	// The first frame may still allocate, e.g. GL state first seen by the cache
+	AnimateLights(lights, 0);
+
+	size_t allocationsBefore = allocations;
+	for (int frame = 1; frame <= 100; frame++)
+		AnimateLights(lights, frame);
+
+	CHECK(allocations == allocationsBefore);
+	// Every frame changes the lights, and each change is sent as one range
+	CHECK(bufferSubDataCalls == 101);
+}
+
+TEST(LightUniformBlockSkipsUnchangedUpload)
+{
+	UseFakeBuffers();
+	LightUniformBlock lights(4);
+	AnimateLights(lights, 0);
+	lights.Upload();
+	lights.Upload();
+
+	CHECK(bufferSubDataCalls == 1);
+}
@@ -0,0 +1,34 @@
+#include "test.h"
+
+namespace Test
+{
+	std::vector<Case>& GetCases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	int& GetFailures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+}
+
+// Returns the number of failed tests, so a build step can fail on it
+int main()
+{
+	int failedTests = 0;
+	for (const Test::Case& testCase : Test::GetCases())
+	{
+		int failuresBefore = Test::GetFailures();
+		testCase.function();
+		bool passed = Test::GetFailures() == failuresBefore;
+		if (!passed)
+			failedTests++;
+		std::cout << (passed ? "[PASS] " : "[FAIL] ") << testCase.name << std::endl;
+	}
+
+	std::cout << Test::GetCases().size() - failedTests << "/" << Test::GetCases().size() << " tests passed" << std::endl;
+	return failedTests;
+}
@@ -0,0 +1,146 @@
+#include "test.h"
+#include "meshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+// Triangles of an n x n quad grid, shuffled so the input order has no locality
+static std::vector<unsigned int> MakeShuffledGrid(unsigned int n)
+{
+	std::vector<std::array<unsigned int, 3>> triangles;
+	for (unsigned int y = 0; y < n; y++)
+	{
+		for (unsigned int x = 0; x < n; x++)
+		{
+			unsigned int corner = y * (n + 1) + x;
+			triangles.push_back({ corner, corner + n + 1, corner + 1 });
+			triangles.push_back({ corner + 1, corner + n + 1, corner + n + 2 });
+		}
+	}
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+
+	std::vector<unsigned int> indices;
+	for (const auto& triangle : triangles)
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
+	return indices;
+}
+
+// Triangles rotated to start at their smallest index and sorted, so two orders of the same mesh compare equal
+static std::vector<std::array<unsigned int, 3>> GetTriangleSet(const std::vector<unsigned int>& indices)
+{
+	std::vector<std::array<unsigned int, 3>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		std::array<unsigned int, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+TEST(AnalyzeVertexCacheSingleTriangle)
+{
+	VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache({ 0, 1, 2 }, 3);
+	CHECK(stats.acmr == 3.f);
+	CHECK(stats.atvr == 1.f);
+}
+
+TEST(AnalyzeVertexCacheSharedEdgeHits)
+{
+	VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache({ 0, 1, 2, 2, 1, 3 }, 4);
+	CHECK(stats.acmr == 2.f);
+	CHECK(stats.atvr == 1.f);
+}
+
+TEST(AnalyzeVertexCacheFifoEviction)
+{
+	std::vector<unsigned int> indices = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+
+	// 0, 1 and 2 were pushed out by 3, 4 and 5
+	VertexCacheStats small = MeshOptimizer::AnalyzeVertexCache(indices, 6, 3);
+	CHECK(small.acmr == 3.f);
+	CHECK(small.atvr == 1.5f);
+
+	VertexCacheStats large = MeshOptimizer::AnalyzeVertexCache(indices, 6, 16);
+	CHECK(large.acmr == 2.f);
+	CHECK(large.atvr == 1.f);
+}
+
+TEST(AnalyzeVertexCacheEmpty)
+{
+	VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache({}, 0);
+	CHECK(stats.acmr == 0.f);
+	CHECK(stats.atvr == 0.f);
+}
+
+TEST(AnalyzeVertexCacheLessThanATriangle)
+{
+	for (const std::vector<unsigned int>& indices : { std::vector<unsigned int>{ 0 }, std::vector<unsigned int>{ 0, 1 } })
+	{
+		VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache(indices, 2);
+		CHECK(stats.acmr == 0.f);
+		CHECK(stats.atvr == 0.f);
+	}
+}
+
+TEST(OptimizeVertexCacheKeepsTrianglesAndLowersAcmr)
+{
+	const unsigned int n = 16;
+	const size_t vertexCount = (n + 1) * (n + 1);
+	std::vector<unsigned int> indices = MakeShuffledGrid(n);
+	std::vector<unsigned int> original = indices;
+
+	MeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+
+	CHECK(GetTriangleSet(indices) == GetTriangleSet(original));
+	float before = MeshOptimizer::AnalyzeVertexCache(original, vertexCount).acmr;
+	float after = MeshOptimizer::AnalyzeVertexCache(indices, vertexCount).acmr;
+	CHECK(after < before);
+	// A regular grid reaches well under one miss per triangle
+	CHECK(after < 1.f);
+}
+
+TEST(OptimizeVertexFetchOrdersByFirstUse)
+{
+	std::vector<int> vertices = { 10, 11, 12, 13, 14 };
+	// Vertex 4 is unused
+	std::vector<unsigned int> indices = { 3, 1, 0, 0, 1, 2 };
+
+	MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+
+	CHECK((vertices == std::vector<int>{ 13, 11, 10, 12 }));
+	CHECK((indices == std::vector<unsigned int>{ 0, 1, 2, 2, 1, 3 }));
+}
+
+TEST(IndicesInRange)
+{
+	CHECK(MeshOptimizer::AreIndicesInRange({ 0, 1, 2 }, 3));
+	CHECK(MeshOptimizer::AreIndicesInRange({}, 0));
+	CHECK(!MeshOptimizer::AreIndicesInRange({ 0, 1, 3 }, 3));
+	// The cube that used to index past its 24 vertices
+	CHECK(!MeshOptimizer::AreIndicesInRange({ 24, 25, 26 }, 24));
+}
+
+// Debug builds assert on these instead
+#ifdef NDEBUG
+TEST(OutOfRangeIndicesLeaveInputUnchanged)
+{
+	std::vector<int> vertices = { 10, 11, 12 };
+	std::vector<unsigned int> indices = { 2, 1, 0, 0, 1, 5 };
+	const std::vector<int> originalVertices = vertices;
+	const std::vector<unsigned int> originalIndices = indices;
+
+	MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+	CHECK(indices == originalIndices);
+
+	MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+	CHECK(vertices == originalVertices);
+	CHECK(indices == originalIndices);
+
+	VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+	CHECK(stats.acmr == 0.f);
+	CHECK(stats.atvr == 0.f);
+}
+#endif
@@ -0,0 +1,80 @@
+#include "test.h"
+#include "ShaderCache.h"
+
+#include <filesystem>
+#include <fstream>
+
+// Entries go to a scratch directory under the system temp directory, emptied by every test
+static std::string MakeEntryPath()
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "shaderCacheTests";
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::create_directories(directory, error);
+	return (directory / "entry.bin").string();
+}
+
+static std::vector<char> MakeBinary(size_t size)
+{
+	std::vector<char> binary(size);
+	for (size_t i = 0; i < size; i++)
+		binary[i] = (char)(i * 31 + 7);
+	return binary;
+}
+
+TEST(ShaderCacheEntryRoundTrip)
+{
+	std::string path = MakeEntryPath();
+	std::vector<char> stored = MakeBinary(1000);
+	CHECK(ShaderCache::WriteEntry(path, 0x8E21, stored));
+
+	uint32_t format = 0;
+	std::vector<char> loaded;
+	CHECK(ShaderCache::ReadEntry(path, format, loaded));
+	CHECK(format == 0x8E21);
+	CHECK(loaded == stored);
+	// Nothing is left behind by the write
+	CHECK(!std::filesystem::exists(path + ".tmp"));
+}
+
+TEST(ShaderCacheEntryReplacesOldEntry)
+{
+	std::string path = MakeEntryPath();
+	CHECK(ShaderCache::WriteEntry(path, 1, MakeBinary(1000)));
+	CHECK(ShaderCache::WriteEntry(path, 2, MakeBinary(10)));
+
+	uint32_t format = 0;
+	std::vector<char> loaded;
+	CHECK(ShaderCache::ReadEntry(path, format, loaded));
+	CHECK(format == 2);
+	CHECK(loaded == MakeBinary(10));
+}
+
+TEST(ShaderCacheEntryRejectsMismatchedHeader)
+{
+	std::string path = MakeEntryPath();
+	uint32_t format = 0;
+	std::vector<char> loaded;
+	CHECK(!ShaderCache::ReadEntry(path, format, loaded));
+
+	// The header says 100 bytes, the file has one more
+	CHECK(ShaderCache::WriteEntry(path, 1, MakeBinary(100)));
+	std::ofstream(path, std::ios::binary | std::ios::app).put('x');
+	CHECK(!ShaderCache::ReadEntry(path, format, loaded));
+
+	// Truncated to less than the binary
+	CHECK(ShaderCache::WriteEntry(path, 1, MakeBinary(100)));
+	std::filesystem::resize_file(path, 50);
+	CHECK(!ShaderCache::ReadEntry(path, format, loaded));
+
+	// Wrong magic
+	CHECK(ShaderCache::WriteEntry(path, 1, MakeBinary(100)));
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.put(0);
+	}
+	CHECK(!ShaderCache::ReadEntry(path, format, loaded));
+
+	// An empty binary is never written
+	CHECK(!ShaderCache::WriteEntry(path, 1, {}));
+}
@@ -0,0 +1,126 @@
+#include "test.h"
+#include "ShaderParser.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+// Scratch directory under the system temp directory, emptied on every call
+static std::filesystem::path MakeCorpusDirectory(const char* name)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::create_directories(directory, error);
+	ShaderParser::ClearIncludeCache();
+	return directory;
+}
+
+static void WriteFile(const std::filesystem::path& path, const std::string& contents)
+{
+	std::ofstream(path, std::ios::binary) << contents;
+}
+
+// Roughly the size and shape of lit.shader: both stages include a shared file
+static std::string MakeShaderSource(int index)
+{
+	std::string source =
+		"#shader vertex\n"
+		"#version 330 core\n"
+		"#include \"common.glsl\"\n"
+		"layout(location = 0) in vec3 aPos;\n"
+		"layout(location = 1) in vec3 aNormal;\n"
+		"out vec3 Normal;\n"
+		"void main()\n"
+		"{\n"
+		"\tNormal = aNormal;\n"
+		"\tgl_Position = viewProjection * vec4(aPos * " + std::to_string(index) + ".0, 1.0);\n"
+		"}\n"
+		"#shader fragment\n"
+		"#version 330 core\n"
+		"#include \"common.glsl\"\n"
+		"#include \"common.glsl\"\n"
+		"in vec3 Normal;\n"
+		"out vec4 FragColor;\n"
+		"void main()\n"
+		"{\n";
+	for (int i = 0; i < 40; i++)
+		source += "\tFragColor += vec4(Normal * " + std::to_string(i) + ".0, 1.0);\n";
+	source += "}\n";
+	return source;
+}
+
+static const char* COMMON_SOURCE =
+	"layout(std140) uniform Camera\n"
+	"{\n"
+	"\tmat4 view;\n"
+	"\tmat4 projection;\n"
+	"\tmat4 viewProjection;\n"
+	"\tvec4 position;\n"
+	"};\n";
+
+static size_t Count(const std::string& text, const std::string& pattern)
+{
+	size_t count = 0;
+	for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+		count++;
+	return count;
+}
+
+TEST(ShaderParserSplitsStagesAndExpandsIncludesOnce)
+{
+	std::filesystem::path directory = MakeCorpusDirectory("shaderParserTests");
+	WriteFile(directory / "common.glsl", COMMON_SOURCE);
+	WriteFile(directory / "test.shader", MakeShaderSource(1));
+
+	ShaderProgamSource source = ShaderParser::Parse((directory / "test.shader").string(), { "MAX_LIGHTS 8" });
+	CHECK(source.vertexSource.find("gl_Position") != std::string::npos);
+	CHECK(source.vertexSource.find("FragColor") == std::string::npos);
+	CHECK(source.fragmentSource.find("FragColor") != std::string::npos);
+	// Included once per stage, the second #include of the fragment stage is guarded
+	CHECK(Count(source.vertexSource, "uniform Camera") == 1);
+	CHECK(Count(source.fragmentSource, "uniform Camera") == 1);
+	CHECK(Count(source.vertexSource, "#include") == 0);
+	// Defines follow #version, which stays the first line
+	CHECK(source.vertexSource.rfind("#version 330 core\n#define MAX_LIGHTS 8\n", 0) == 0);
+	CHECK(source.fragmentSource.rfind("#version 330 core\n#define MAX_LIGHTS 8\n", 0) == 0);
+}
+
+TEST(ShaderParserSkipsUnknownSection)
+{
+	std::filesystem::path directory = MakeCorpusDirectory("shaderParserTests");
+	WriteFile(directory / "test.shader", "#shader geometry\nlost\n#shader vertex\nkept\n");
+
+	ShaderProgamSource source = ShaderParser::Parse((directory / "test.shader").string());
+	CHECK(source.vertexSource == "kept\n");
+	CHECK(source.fragmentSource.empty());
+}
+
+// Benchmark of the request: 10k generated .shader files sharing one include, reports the time per file
+TEST(ShaderParserParses10kFiles)
+{
+	const int FILE_COUNT = 10000;
+	std::filesystem::path directory = MakeCorpusDirectory("shaderParserCorpus");
+	WriteFile(directory / "common.glsl", COMMON_SOURCE);
+	std::vector<std::string> paths;
+	for (int i = 0; i < FILE_COUNT; i++)
+	{
+		paths.push_back((directory / ("shader" + std::to_string(i) + ".shader")).string());
+		WriteFile(paths.back(), MakeShaderSource(i));
+	}
+
+	size_t parsedBytes = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const std::string& path : paths)
+	{
+		ShaderProgamSource source = ShaderParser::Parse(path, { "MAX_LIGHTS 64" });
+		parsedBytes += source.vertexSource.size() + source.fragmentSource.size();
+	}
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	CHECK(parsedBytes > 0);
+	std::cout << "  parsed " << FILE_COUNT << " files in " << milliseconds << " ms, " << milliseconds * 1000.0 / FILE_COUNT << " us/file" << std::endl;
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
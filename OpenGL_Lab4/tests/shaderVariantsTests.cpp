@@ -0,0 +1,14 @@
+#include "test.h"
+#include "ShaderVariants.h"
+
+TEST(ShaderVariantsKeysDontAliasLightCounts)
+{
+	// Main.cpp creates the light block with 256 lights
+	CHECK(ShaderVariants::MakeKey(false, 256) != ShaderVariants::MakeKey(false, 255));
+	CHECK(ShaderVariants::MakeKey(true, 256) != ShaderVariants::MakeKey(false, 256));
+	CHECK(((ShaderVariants::MakeKey(true, 256) & ShaderVariants::NUM_LIGHTS_MASK) >> ShaderVariants::NUM_LIGHTS_SHIFT) == 256);
+	CHECK((ShaderVariants::MakeKey(true, 256) & ShaderVariants::HAS_TEXTURE) != 0);
+	// Out of range counts are clamped instead of spilling into other bits
+	CHECK(ShaderVariants::MakeKey(false, -1) == ShaderVariants::MakeKey(false, 0));
+	CHECK(ShaderVariants::MakeKey(false, 0x10000) == ShaderVariants::MakeKey(false, ShaderVariants::NUM_LIGHTS_MAX));
+}
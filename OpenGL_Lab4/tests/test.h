@@ -0,0 +1,40 @@
+#pragma once
+#include <iostream>
+#include <vector>
+
+/// <summary>
+/// Minimal test registry for the CPU-side code. TEST defines a function that main.cpp runs,
+/// CHECK reports a failed condition with its location and lets the test continue
+/// </summary>
+namespace Test
+{
+	struct Case
+	{
+		const char* name;
+		void (*function)();
+	};
+
+	std::vector<Case>& GetCases();
+	// Failed checks since the start of the run
+	int& GetFailures();
+
+	struct Registration
+	{
+		Registration(const char* name, void (*function)()) { GetCases().push_back({ name, function }); }
+	};
+}
+
+#define TEST(name) \
+	static void name(); \
+	static Test::Registration name##Registration(#name, name); \
+	static void name()
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			Test::GetFailures()++; \
+			std::cout << __FILE__ << "(" << __LINE__ << "): CHECK(" #condition ") failed" << std::endl; \
+		} \
+	} while (0)